@@ -20,6 +20,8 @@
 
 #include "util/error.h"
 
+#include <algorithm>
+
 namespace clanguml::class_diagram::model {
 using nlohmann::json;
 
@@ -146,105 +148,110 @@ void generator::generate_diagram(nlohmann::json &parent) const
 
     if (config().generate_packages.has_value)
         parent["package_type"] = to_string(config().package_type());
-    parent["elements"] = std::vector<nlohmann::json>{};
-    parent["relationships"] = std::vector<nlohmann::json>{};
+}
 
-    generate_top_level_elements(parent);
+void generator::generate_streamed_members(
+    common::generators::json::streamed_members_t &members) const
+{
+    members.emplace("elements", [this](writer &w) {
+        w.begin_array();
+        generate_top_level_elements(w);
+        w.end_array();
+    });
+
+    members.emplace("relationships", [this](writer &w) {
+        w.begin_array();
+        generate_relationships(w);
+        w.end_array();
+    });
+}
 
-    generate_relationships(parent);
+bool generator::should_generate(const common::model::element &e) const
+{
+    if (const auto *pkg = dynamic_cast<const package *>(&e); pkg)
+        return !pkg->is_empty() &&
+            !pkg->all_of([this](const common::model::element &el) {
+                return !model().should_include(el);
+            });
+
+    if (dynamic_cast<const class_ *>(&e) != nullptr ||
+        dynamic_cast<const enum_ *>(&e) != nullptr ||
+        dynamic_cast<const concept_ *>(&e) != nullptr)
+        return model().should_include(e);
+
+    return false;
 }
 
-void generator::generate_top_level_elements(nlohmann::json &parent) const
+void generator::generate_element(
+    const common::model::element &e, writer &w) const
+{
+    if (auto *pkg = dynamic_cast<const package *>(&e); pkg)
+        generate(*pkg, w);
+    else if (auto *cls = dynamic_cast<const class_ *>(&e); cls)
+        generate(*cls, w);
+    else if (auto *enm = dynamic_cast<const enum_ *>(&e); enm)
+        generate(*enm, w);
+    else if (auto *cpt = dynamic_cast<const concept_ *>(&e); cpt)
+        generate(*cpt, w);
+}
+
+void generator::generate_top_level_elements(writer &w) const
 {
     for (const auto &p : model()) {
-        if (auto *pkg = dynamic_cast<package *>(p.get()); pkg) {
-            if (!pkg->is_empty() &&
-                !pkg->all_of([this](const common::model::element &e) {
-                    return !model().should_include(e);
-                }))
-                generate(*pkg, parent);
-        }
-        else if (auto *cls = dynamic_cast<class_ *>(p.get()); cls) {
-            if (model().should_include(*cls)) {
-                generate(*cls, parent);
-            }
-        }
-        else if (auto *enm = dynamic_cast<enum_ *>(p.get()); enm) {
-            if (model().should_include(*enm)) {
-                generate(*enm, parent);
-            }
-        }
-        else if (auto *cpt = dynamic_cast<concept_ *>(p.get()); cpt) {
-            if (model().should_include(*cpt)) {
-                generate(*cpt, parent);
-            }
-        }
+        if (should_generate(*p))
+            generate_element(*p, w);
     }
 }
 
-void generator::generate(const package &p, nlohmann::json &parent) const
+void generator::generate(const package &p, writer &w) const
 {
+    if (!config().generate_packages()) {
+        for (const auto &subpackage : p) {
+            if (should_generate(*subpackage))
+                generate_element(*subpackage, w);
+        }
+        return;
+    }
+
     const auto &uns = config().using_namespace();
 
-    nlohmann::json package_object;
+    // Don't generate packages from namespaces filtered out by
+    // using_namespace
+    const auto has_header = !uns.starts_with({p.full_name(false)});
+    const auto has_elements = std::any_of(p.begin(), p.end(),
+        [this](const auto &e) { return should_generate(*e); });
 
-    if (config().generate_packages()) {
-        // Don't generate packages from namespaces filtered out by
-        // using_namespace
-        if (!uns.starts_with({p.full_name(false)})) {
-            LOG_DBG("Generating package {}", p.name());
+    if (!has_header && !has_elements)
+        return;
 
-            package_object["type"] = to_string(config().package_type());
-            package_object["name"] = p.name();
-            package_object["display_name"] = p.name();
-        }
+    // Object keys must be written in sorted order
+    w.begin_object();
+
+    if (has_header) {
+        LOG_DBG("Generating package {}", p.name());
+
+        w.member("display_name", p.name());
     }
 
-    for (const auto &subpackage : p) {
-        if (dynamic_cast<package *>(subpackage.get()) != nullptr) {
-            const auto &sp = dynamic_cast<package &>(*subpackage);
-            if (!sp.is_empty() &&
-                !sp.all_of([this](const common::model::element &e) {
-                    return !model().should_include(e);
-                })) {
-                if (config().generate_packages())
-                    generate(sp, package_object);
-                else
-                    generate(sp, parent);
-            }
-        }
-        else if (auto *cls = dynamic_cast<class_ *>(subpackage.get()); cls) {
-            if (model().should_include(*cls)) {
-                if (config().generate_packages())
-                    generate(*cls, package_object);
-                else
-                    generate(*cls, parent);
-            }
-        }
-        else if (auto *enm = dynamic_cast<enum_ *>(subpackage.get()); enm) {
-            if (model().should_include(*enm)) {
-                if (config().generate_packages())
-                    generate(*enm, package_object);
-                else
-                    generate(*enm, parent);
-            }
-        }
-        else if (auto *cpt = dynamic_cast<concept_ *>(subpackage.get()); cpt) {
-            if (model().should_include(*cpt)) {
-                if (config().generate_packages())
-                    generate(*cpt, package_object);
-                else
-                    generate(*cpt, parent);
-            }
+    if (has_elements) {
+        w.key("elements");
+        w.begin_array();
+        for (const auto &subpackage : p) {
+            if (should_generate(*subpackage))
+                generate_element(*subpackage, w);
         }
+        w.end_array();
     }
 
-    if (config().generate_packages() && !package_object.empty()) {
-        parent["elements"].push_back(std::move(package_object));
+    if (has_header) {
+        w.member("name", p.name());
+        w.member("type", to_string(config().package_type()));
     }
+
+    w.end_object();
 }
 
-void generator::generate(const class_ &c, nlohmann::json &parent) const
+void generator::generate(const class_ &c, writer &w) const
 {
     nlohmann::json object = c;
 
@@ -264,12 +271,10 @@ void generator::generate(const class_ &c, nlohmann::json &parent) const
         }
     }
 
-    std::string object_str = object.dump(2);
-
-    parent["elements"].push_back(std::move(object));
+    w.value(object);
 }
 
-void generator::generate(const enum_ &e, nlohmann::json &parent) const
+void generator::generate(const enum_ &e, writer &w) const
 {
     nlohmann::json object = e;
 
@@ -277,10 +282,10 @@ void generator::generate(const enum_ &e, nlohmann::json &parent) const
         object["display_name"] =
             common::generators::json::render_name(e.full_name_no_ns());
 
-    parent["elements"].push_back(std::move(object));
+    w.value(object);
 }
 
-void generator::generate(const concept_ &c, nlohmann::json &parent) const
+void generator::generate(const concept_ &c, writer &w) const
 {
     nlohmann::json object = c;
 
@@ -288,37 +293,37 @@ void generator::generate(const concept_ &c, nlohmann::json &parent) const
         object["display_name"] =
             common::generators::json::render_name(c.full_name_no_ns());
 
-    parent["elements"].push_back(std::move(object));
+    w.value(object);
 }
 
-void generator::generate_relationships(nlohmann::json &parent) const
+void generator::generate_relationships(writer &w) const
 {
     for (const auto &p : model()) {
         if (auto *pkg = dynamic_cast<package *>(p.get()); pkg) {
-            generate_relationships(*pkg, parent);
+            generate_relationships(*pkg, w);
         }
         else if (auto *cls = dynamic_cast<class_ *>(p.get()); cls) {
             if (model().should_include(*cls)) {
-                generate_relationships(*cls, parent);
+                generate_relationships(*cls, w);
             }
         }
         else if (auto *enm = dynamic_cast<enum_ *>(p.get()); enm) {
             if (model().should_include(*enm)) {
-                generate_relationships(*enm, parent);
+                generate_relationships(*enm, w);
             }
         }
         else if (auto *cpt = dynamic_cast<concept_ *>(p.get()); cpt) {
             if (model().should_include(*cpt)) {
-                generate_relationships(*cpt, parent);
+                generate_relationships(*cpt, w);
             }
         }
     }
 }
 
-void generator::generate_relationships(
-    const class_ &c, nlohmann::json &parent) const
+void generator::generate_element_relationships(
+    const common::model::element &e, writer &w) const
 {
-    for (const auto &r : c.relationships()) {
+    for (const auto &r : e.relationships()) {
         if (!model().should_include(r))
             continue;
 
@@ -326,14 +331,19 @@ void generator::generate_relationships(
         if (!target_element.has_value()) {
             LOG_DBG("Skipping {} relation from {} to {} due "
                     "to unresolved destination id",
-                to_string(r.type()), c.full_name(), r.destination());
+                to_string(r.type()), e.full_name(), r.destination());
             continue;
         }
 
         nlohmann::json rel = r;
-        rel["source"] = std::to_string(c.id().value());
-        parent["relationships"].push_back(rel);
+        rel["source"] = std::to_string(e.id().value());
+        w.value(rel);
     }
+}
+
+void generator::generate_relationships(const class_ &c, writer &w) const
+{
+    generate_element_relationships(c, w);
 
     if (model().should_include(relationship_t::kExtension)) {
         for (const auto &b : c.parents()) {
@@ -341,78 +351,44 @@ void generator::generate_relationships(
                 relationship_t::kExtension, b.id(), b.access());
             nlohmann::json rel = r;
             rel["source"] = std::to_string(c.id().value());
-            parent["relationships"].push_back(rel);
+            w.value(rel);
         }
     }
 }
 
-void generator::generate_relationships(
-    const enum_ &c, nlohmann::json &parent) const
+void generator::generate_relationships(const enum_ &c, writer &w) const
 {
-    for (const auto &r : c.relationships()) {
-        if (!model().should_include(r))
-            continue;
-
-        auto target_element = model().get(r.destination());
-        if (!target_element.has_value()) {
-            LOG_DBG("Skipping {} relation from {} to {} due "
-                    "to unresolved destination id",
-                to_string(r.type()), c.full_name(), r.destination());
-            continue;
-        }
-
-        nlohmann::json rel = r;
-        rel["source"] = std::to_string(c.id().value());
-        parent["relationships"].push_back(rel);
-    }
+    generate_element_relationships(c, w);
 }
 
-void generator::generate_relationships(
-    const concept_ &c, nlohmann::json &parent) const
+void generator::generate_relationships(const concept_ &c, writer &w) const
 {
-    for (const auto &r : c.relationships()) {
-        if (!model().should_include(r))
-            continue;
-
-        auto target_element = model().get(r.destination());
-        if (!target_element.has_value()) {
-            LOG_DBG("Skipping {} relation from {} to {} due "
-                    "to unresolved destination id",
-                to_string(r.type()), c.full_name(), r.destination());
-            continue;
-        }
-
-        nlohmann::json rel = r;
-        rel["source"] = std::to_string(c.id().value());
-        parent["relationships"].push_back(rel);
-    }
+    generate_element_relationships(c, w);
 }
 
-void generator::generate_relationships(
-    const package &p, nlohmann::json &parent) const
+void generator::generate_relationships(const package &p, writer &w) const
 {
     for (const auto &subpackage : p) {
         if (dynamic_cast<package *>(subpackage.get()) != nullptr) {
             const auto &sp = dynamic_cast<package &>(*subpackage);
             if (!sp.is_empty())
-                generate_relationships(sp, parent);
+                generate_relationships(sp, w);
         }
         else if (dynamic_cast<class_ *>(subpackage.get()) != nullptr) {
             if (model().should_include(*subpackage)) {
                 generate_relationships(
-                    dynamic_cast<class_ &>(*subpackage), parent);
+                    dynamic_cast<class_ &>(*subpackage), w);
             }
         }
         else if (dynamic_cast<enum_ *>(subpackage.get()) != nullptr) {
             if (model().should_include(*subpackage)) {
-                generate_relationships(
-                    dynamic_cast<enum_ &>(*subpackage), parent);
+                generate_relationships(dynamic_cast<enum_ &>(*subpackage), w);
             }
         }
         else if (dynamic_cast<concept_ *>(subpackage.get()) != nullptr) {
             if (model().should_include(*subpackage)) {
                 generate_relationships(
-                    dynamic_cast<concept_ &>(*subpackage), parent);
+                    dynamic_cast<concept_ &>(*subpackage), w);
             }
         }
     }
@@ -50,6 +50,7 @@ using clanguml::class_diagram::model::class_;
 using clanguml::class_diagram::model::class_element;
 using clanguml::class_diagram::model::concept_;
 using clanguml::class_diagram::model::enum_;
+using clanguml::common::generators::json::writer;
 using clanguml::common::model::access_t;
 using clanguml::common::model::package;
 using clanguml::common::model::relationship_t;
@@ -76,36 +77,47 @@ public:
     void generate_diagram(nlohmann::json &parent) const override;
 
     /**
-     * Render class element into a JSON node.
+     * @brief Generate diagram elements and relationships
+     *
+     * Elements and relationships are written directly to the output stream,
+     * one at a time.
+     *
+     * @param members Streamed members of the root JSON object
+     */
+    void generate_streamed_members(
+        common::generators::json::streamed_members_t &members) const override;
+
+    /**
+     * Render class element into a JSON array.
      *
      * @param c class diagram element
-     * @param parent JSON node
+     * @param w JSON writer
      */
-    void generate(const class_ &c, nlohmann::json &parent) const;
+    void generate(const class_ &c, writer &w) const;
 
     /**
-     * Render enum element into a JSON node.
+     * Render enum element into a JSON array.
      *
      * @param c enum diagram element
-     * @param parent JSON node
+     * @param w JSON writer
      */
-    void generate(const enum_ &c, nlohmann::json &parent) const;
+    void generate(const enum_ &c, writer &w) const;
 
     /**
-     * Render concept element into a JSON node.
+     * Render concept element into a JSON array.
      *
      * @param c concept diagram element
-     * @param parent JSON node
+     * @param w JSON writer
      */
-    void generate(const concept_ &c, nlohmann::json &parent) const;
+    void generate(const concept_ &c, writer &w) const;
 
     /**
-     * Render package element into a JSON node.
+     * Render package element into a JSON array.
      *
      * @param p package diagram element
-     * @param parent JSON node
+     * @param w JSON writer
      */
-    void generate(const package &p, nlohmann::json &parent) const;
+    void generate(const package &p, writer &w) const;
 
     /**
      * @brief In a nested diagram, generate the top level elements.
@@ -114,41 +126,40 @@ public:
      * is nested (i.e. includes packages), for each package it recursively
      * call generation of elements contained in each package.
      *
-     * @param parent JSON node
+     * @param w JSON writer
      */
-    void generate_top_level_elements(nlohmann::json &parent) const;
+    void generate_top_level_elements(writer &w) const;
 
     /**
      * @brief Generate all relationships in the diagram.
      *
-     * @param parent JSON node
+     * @param w JSON writer
      */
-    void generate_relationships(nlohmann::json &parent) const;
+    void generate_relationships(writer &w) const;
 
     /**
      * @brief Generate all relationships originating at a class element.
      *
      * @param c Class diagram element
-     * @param parent JSON node
+     * @param w JSON writer
      */
-    void generate_relationships(const class_ &c, nlohmann::json &parent) const;
+    void generate_relationships(const class_ &c, writer &w) const;
 
     /**
      * @brief Generate all relationships originating at an enum element.
      *
      * @param c Enum diagram element
-     * @param parent JSON node
+     * @param w JSON writer
      */
-    void generate_relationships(const enum_ &c, nlohmann::json &parent) const;
+    void generate_relationships(const enum_ &c, writer &w) const;
 
     /**
      * @brief Generate all relationships originating at a concept element.
      *
      * @param c Concept diagram element
-     * @param parent JSON node
+     * @param w JSON writer
      */
-    void generate_relationships(
-        const concept_ &c, nlohmann::json &parent) const;
+    void generate_relationships(const concept_ &c, writer &w) const;
 
     /**
      * @brief Generate all relationships in a package.
@@ -157,9 +168,37 @@ public:
      * for all subelements.
      *
      * @param p Package diagram element
-     * @param parent JSON node
+     * @param w JSON writer
+     */
+    void generate_relationships(const package &p, writer &w) const;
+
+private:
+    /**
+     * @brief Check whether element should be rendered in the diagram
+     *
+     * Packages are rendered only if they contain any included elements.
+     *
+     * @param e Diagram element
+     * @return True, if the element should be rendered
+     */
+    bool should_generate(const common::model::element &e) const;
+
+    /**
+     * @brief Render a package, class, enum or concept into a JSON array
+     *
+     * @param e Diagram element
+     * @param w JSON writer
+     */
+    void generate_element(const common::model::element &e, writer &w) const;
+
+    /**
+     * @brief Generate relationships of an element to included elements
+     *
+     * @param e Diagram element
+     * @param w JSON writer
      */
-    void generate_relationships(const package &p, nlohmann::json &parent) const;
+    void generate_element_relationships(
+        const common::model::element &e, writer &w) const;
 };
 
 } // namespace json
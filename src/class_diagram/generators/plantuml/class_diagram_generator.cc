@@ -36,18 +36,14 @@ void generator::generate_link(
     if (e.file_relative().empty())
         return;
 
-    auto context = element_context(e);
-
     if (!config().generate_links().link.empty()) {
         ostr << " [[[";
-        ostr << env().render(
-            std::string_view{config().generate_links().link}, context);
+        ostr << render_element_template(config().generate_links().link, e);
     }
 
     if (!config().generate_links().tooltip.empty()) {
         ostr << "{";
-        ostr << env().render(
-            std::string_view{config().generate_links().tooltip}, context);
+        ostr << render_element_template(config().generate_links().tooltip, e);
         ostr << "}";
     }
     ostr << "]]]";
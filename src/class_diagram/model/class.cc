@@ -67,6 +67,19 @@ const std::vector<class_parent> &class_::parents() const { return bases_; }
 bool operator==(const class_ &l, const class_ &r) { return l.id() == r.id(); }
 
 std::string class_::full_name_no_ns() const
+{
+    return cached_full_name(full_name_t::kNoNamespace,
+        [this]() { return render_full_name_no_ns(); });
+}
+
+std::string class_::full_name(bool relative) const
+{
+    return cached_full_name(
+        relative ? full_name_t::kRelative : full_name_t::kAbsolute,
+        [this, relative]() { return render_full_name(relative); });
+}
+
+std::string class_::render_full_name_no_ns() const
 {
     using namespace clanguml::util;
 
@@ -79,7 +92,7 @@ std::string class_::full_name_no_ns() const
     return ostr.str();
 }
 
-std::string class_::full_name(bool relative) const
+std::string class_::render_full_name(bool relative) const
 {
     using namespace clanguml::util;
     using clanguml::common::model::namespace_;
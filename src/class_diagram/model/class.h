@@ -167,13 +167,16 @@ public:
     std::optional<std::string> doxygen_link() const override;
 
 private:
+    std::string render_full_name(bool relative) const;
+
+    std::string render_full_name_no_ns() const;
+
     bool is_struct_{false};
     bool is_union_{false};
     std::vector<class_member> members_;
     std::vector<class_method> methods_;
     std::vector<class_parent> bases_;
     std::string base_template_full_name_;
-    std::string full_name_;
 };
 
 } // namespace clanguml::class_diagram::model
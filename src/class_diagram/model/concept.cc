@@ -34,6 +34,19 @@ bool operator==(const concept_ &l, const concept_ &r)
 }
 
 std::string concept_::full_name_no_ns() const
+{
+    return cached_full_name(full_name_t::kNoNamespace,
+        [this]() { return render_full_name_no_ns(); });
+}
+
+std::string concept_::full_name(bool relative) const
+{
+    return cached_full_name(
+        relative ? full_name_t::kRelative : full_name_t::kAbsolute,
+        [this, relative]() { return render_full_name(relative); });
+}
+
+std::string concept_::render_full_name_no_ns() const
 {
     using namespace clanguml::util;
 
@@ -46,7 +59,7 @@ std::string concept_::full_name_no_ns() const
     return ostr.str();
 }
 
-std::string concept_::full_name(bool relative) const
+std::string concept_::render_full_name(bool relative) const
 {
     using namespace clanguml::util;
     using clanguml::common::model::namespace_;
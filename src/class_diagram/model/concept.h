@@ -87,7 +87,17 @@ public:
      */
     const std::vector<std::string> &requires_statements() const;
 
+protected:
+    void on_template_params_changed() override
+    {
+        invalidate_full_name_cache();
+    }
+
 private:
+    std::string render_full_name(bool relative) const;
+
+    std::string render_full_name_no_ns() const;
+
     std::vector<std::string> requires_expression_;
 
     std::vector<method_parameter> requires_parameters_;
@@ -22,6 +22,10 @@
 #include "util/error.h"
 #include "util/util.h"
 
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
 namespace clanguml::class_diagram::model {
 
 bool diagram::should_include(const class_member &m) const
@@ -155,41 +159,23 @@ void diagram::get_parents(
 
 bool diagram::has_element(eid_t id) const
 {
-    const auto has_class = std::any_of(classes().begin(), classes().end(),
-        [id](const auto &c) { return c.get().id() == id; });
-
-    if (has_class)
-        return true;
-
-    const auto has_concept = std::any_of(classes().begin(), classes().end(),
-        [id](const auto &c) { return c.get().id() == id; });
-
-    if (has_concept)
-        return true;
-
-    return std::any_of(enums().begin(), enums().end(),
-        [id](const auto &c) { return c.get().id() == id; });
+    return element_view<class_>::contains(id) ||
+        element_view<concept_>::contains(id) ||
+        element_view<enum_>::contains(id);
 }
 
 std::string diagram::to_alias(eid_t id) const
 {
     LOG_DBG("Looking for alias for {}", id);
 
-    for (const auto &c : classes()) {
-        if (c.get().id() == id) {
-            return c.get().alias();
-        }
-    }
+    if (auto c = find<class_>(id); c)
+        return c.value().alias();
 
-    for (const auto &e : enums()) {
-        if (e.get().id() == id)
-            return e.get().alias();
-    }
+    if (auto e = find<enum_>(id); e)
+        return e.value().alias();
 
-    for (const auto &c : concepts()) {
-        if (c.get().id() == id)
-            return c.get().alias();
-    }
+    if (auto c = find<concept_>(id); c)
+        return c.value().alias();
 
     throw error::uml_alias_missing(fmt::format("Missing alias for {}", id));
 }
@@ -256,6 +242,45 @@ void diagram::remove_redundant_dependencies()
     }
 }
 
+void diagram::merge(diagram &&other)
+{
+    std::unordered_set<const common::model::element *> moved;
+    std::vector<std::pair<const common::model::element *,
+        common::model::element *>>
+        replaced;
+
+    merge_elements(
+        other,
+        [&moved](const common::model::element &e) { moved.emplace(&e); },
+        [&replaced](common::model::element &existing,
+            common::model::element &duplicate) {
+            // Keep the element which was added first, the same as add()
+            // does when visiting translation units sequentially, unless
+            // only its forward declaration was visited so far
+            if (existing.complete() || !duplicate.complete() ||
+                typeid(existing) != typeid(duplicate))
+                return false;
+
+            replaced.emplace_back(&existing, &duplicate);
+
+            return true;
+        });
+
+    for (auto [existing, replacement] : replaced) {
+        if (auto *c = dynamic_cast<class_ *>(replacement); c != nullptr)
+            replace_in_view(dynamic_cast<const class_ &>(*existing), *c);
+        else if (auto *e = dynamic_cast<enum_ *>(replacement); e != nullptr)
+            replace_in_view(dynamic_cast<const enum_ &>(*existing), *e);
+        else if (auto *cpt = dynamic_cast<concept_ *>(replacement);
+                 cpt != nullptr)
+            replace_in_view(dynamic_cast<const concept_ &>(*existing), *cpt);
+    }
+
+    merge_element_view<class_>(other, moved);
+    merge_element_view<enum_>(other, moved);
+    merge_element_view<concept_>(other, moved);
+}
+
 bool diagram::is_empty() const
 {
     return element_view<class_>::is_empty() &&
@@ -29,6 +29,8 @@
 
 #include <regex>
 #include <string>
+#include <tuple>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -242,6 +244,22 @@ public:
      */
     void remove_redundant_dependencies();
 
+    /**
+     * @brief Merge elements from another partial diagram model.
+     *
+     * This method is used to combine diagram models built from separate
+     * subsets of translation units. Elements already in the model take
+     * precedence over their duplicates, unless only the duplicate is
+     * complete (e.g. when the element was only forward declared in the
+     * translation units of this model). New elements are appended in their
+     * original order, so that merging models of consecutive translation unit
+     * ranges results in the same model as visiting all translation units
+     * sequentially.
+     *
+     * @param other Diagram model to merge into this diagram
+     */
+    void merge(diagram &&other);
+
     /**
      * @brief Return the elements JSON context for inja templates.
      *
@@ -257,6 +275,32 @@ public:
     bool is_empty() const override;
 
 private:
+    template <typename ElementT>
+    using name_index_t =
+        std::unordered_map<std::string, std::reference_wrapper<ElementT>>;
+
+    /**
+     * @brief Add element to the typed view and to the name index
+     *
+     * @tparam ElementT Type of diagram element
+     * @param e Reference to the element, owned by the diagram
+     */
+    template <typename ElementT> void add_to_view(ElementT &e);
+
+    /**
+     * @brief Replace element in the typed view and in the name index
+     *
+     * @tparam ElementT Type of diagram element
+     * @param existing Element in this diagram
+     * @param replacement Element with the same id, owned by the diagram
+     */
+    template <typename ElementT>
+    void replace_in_view(const ElementT &existing, ElementT &replacement);
+
+    template <typename ElementT>
+    void merge_element_view(const diagram &other,
+        const std::unordered_set<const common::model::element *> &moved);
+
     template <typename ElementT>
     bool add_with_namespace_path(std::unique_ptr<ElementT> &&e);
 
@@ -267,14 +311,70 @@ private:
     template <typename ElementT>
     bool add_with_filesystem_path(
         const common::model::path &parent_path, std::unique_ptr<ElementT> &&e);
+
+    /*!
+     * Elements of each type indexed by their fully qualified name, both
+     * with and without `##` replaced by `::`
+     */
+    std::tuple<name_index_t<class_>, name_index_t<enum_>,
+        name_index_t<concept_>>
+        elements_by_name_;
 };
 
 template <typename ElementT> bool diagram::contains(const ElementT &element)
 {
-    return std::any_of(element_view<ElementT>::view().cbegin(),
-        element_view<ElementT>::view().cend(),
-        [&element](
-            const auto &element_opt) { return element_opt.get() == element; });
+    // Enums are compared by their namespace and name, other elements by id
+    if constexpr (std::is_same_v<ElementT, enum_>) {
+        return find<enum_>(element.full_name(false)).has_value();
+    }
+    else {
+        return element_view<ElementT>::contains(element.id());
+    }
+}
+
+template <typename ElementT> void diagram::add_to_view(ElementT &e)
+{
+    element_view<ElementT>::add(std::ref(e));
+
+    auto &elements_by_name =
+        std::get<name_index_t<ElementT>>(elements_by_name_);
+
+    auto full_name = e.full_name(false);
+    auto full_name_escaped = full_name;
+    util::replace_all(full_name_escaped, "##", "::");
+
+    elements_by_name.try_emplace(std::move(full_name), std::ref(e));
+    elements_by_name.try_emplace(std::move(full_name_escaped), std::ref(e));
+}
+
+template <typename ElementT>
+void diagram::replace_in_view(const ElementT &existing, ElementT &replacement)
+{
+    element_view<ElementT>::replace(existing, replacement);
+
+    auto &elements_by_name =
+        std::get<name_index_t<ElementT>>(elements_by_name_);
+
+    auto full_name = existing.full_name(false);
+    auto full_name_escaped = full_name;
+    util::replace_all(full_name_escaped, "##", "::");
+
+    for (const auto &name : {full_name, full_name_escaped}) {
+        if (auto it = elements_by_name.find(name);
+            it != elements_by_name.end() && &it->second.get() == &existing)
+            it->second = std::ref(replacement);
+    }
+}
+
+template <typename ElementT>
+void diagram::merge_element_view(const diagram &other,
+    const std::unordered_set<const common::model::element *> &moved)
+{
+    for (const auto &e :
+        static_cast<const element_view<ElementT> &>(other).view()) {
+        if (moved.count(&e.get()) > 0)
+            add_to_view(e.get());
+    }
 }
 
 template <typename ElementT>
@@ -303,7 +403,7 @@ bool diagram::add_with_namespace_path(std::unique_ptr<ElementT> &&e)
     try {
         if (!contains(e_ref)) {
             if (add_element(ns, std::move(e)))
-                element_view<ElementT>::add(std::ref(e_ref));
+                add_to_view(e_ref);
 
             const auto &el = get_element<ElementT>(name_and_ns).value();
 
@@ -355,7 +455,7 @@ bool diagram::add_with_module_path(
     auto &e_ref = *e;
 
     if (add_element(parent_path, std::move(e))) {
-        element_view<ElementT>::add(std::ref(e_ref));
+        add_to_view(e_ref);
         return true;
     }
 
@@ -388,7 +488,7 @@ bool diagram::add_with_filesystem_path(
     auto &e_ref = *e;
 
     if (add_element(parent_path, std::move(e))) {
-        element_view<ElementT>::add(std::ref(e_ref));
+        add_to_view(e_ref);
         return true;
     }
 
@@ -398,18 +498,14 @@ bool diagram::add_with_filesystem_path(
 template <typename ElementT>
 opt_ref<ElementT> diagram::find(const std::string &name) const
 {
-    for (const auto &element : element_view<ElementT>::view()) {
-        const auto full_name = element.get().full_name(false);
+    const auto &elements_by_name =
+        std::get<name_index_t<ElementT>>(elements_by_name_);
 
-        auto full_name_escaped = full_name;
-        util::replace_all(full_name_escaped, "##", "::");
+    auto it = elements_by_name.find(name);
+    if (it == elements_by_name.end())
+        return {};
 
-        if (name == full_name || name == full_name_escaped) {
-            return {element};
-        }
-    }
-
-    return {};
+    return {it->second};
 }
 
 template <typename ElementT>
@@ -418,6 +514,13 @@ std::vector<opt_ref<ElementT>> diagram::find(
 {
     std::vector<opt_ref<ElementT>> result;
 
+    if (const auto name = pattern.get<std::string>(); name) {
+        if (auto element = find<ElementT>(*name); element)
+            result.emplace_back(std::move(element));
+
+        return result;
+    }
+
     for (const auto &element : element_view<ElementT>::view()) {
         const auto full_name = element.get().full_name(false);
         auto full_name_escaped = full_name;
@@ -433,13 +536,7 @@ std::vector<opt_ref<ElementT>> diagram::find(
 
 template <typename ElementT> opt_ref<ElementT> diagram::find(eid_t id) const
 {
-    for (const auto &element : element_view<ElementT>::view()) {
-        if (element.get().id() == id) {
-            return {element};
-        }
-    }
-
-    return {};
+    return element_view<ElementT>::get(id);
 }
 
 template <typename ElementT>
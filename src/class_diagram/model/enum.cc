@@ -35,6 +35,13 @@ bool operator==(const enum_ &l, const enum_ &r)
 }
 
 std::string enum_::full_name(bool relative) const
+{
+    return cached_full_name(
+        relative ? full_name_t::kRelative : full_name_t::kAbsolute,
+        [this, relative]() { return render_full_name(relative); });
+}
+
+std::string enum_::render_full_name(bool relative) const
 {
     using namespace clanguml::util;
     using clanguml::common::model::namespace_;
@@ -65,6 +65,8 @@ public:
     std::optional<std::string> doxygen_link() const override;
 
 private:
+    std::string render_full_name(bool relative) const;
+
     std::vector<std::string> constants_;
 };
 
@@ -177,6 +177,8 @@ bool translation_unit_visitor::VisitEnumDecl(clang::EnumDecl *enm)
         e.constants().push_back(ev->getNameAsString());
     }
 
+    e.complete(enm->isCompleteDefinition());
+
     add_enum(std::move(e_ptr));
 
     return true;
@@ -362,6 +364,7 @@ bool translation_unit_visitor::VisitRecordDecl(clang::RecordDecl *rec)
     if (rec->isCompleteDefinition() && !record_model.complete()) {
         process_record_members(rec, record_model);
         record_model.complete(true);
+        visited_element_ids_.emplace(record_model.id());
     }
 
     auto id = record_model.id();
@@ -423,6 +426,8 @@ bool translation_unit_visitor::TraverseConceptDecl(clang::ConceptDecl *cpt)
             *concept_model, cpt->getConstraintExpr());
     }
 
+    concept_model->complete(true);
+
     if (diagram().should_include(*concept_model)) {
         LOG_DBG("Adding concept {} with id {}", concept_model->full_name(false),
             concept_model->id());
@@ -725,8 +730,10 @@ bool translation_unit_visitor::VisitCXXRecordDecl(clang::CXXRecordDecl *cls)
         ? *diagram().find<class_>(cls_id).get()
         : *c_ptr;
 
-    if (cls->isCompleteDefinition() && !class_model.complete())
+    if (cls->isCompleteDefinition() && !class_model.complete()) {
         process_class_declaration(*cls, class_model);
+        visited_element_ids_.emplace(class_model.id());
+    }
 
     auto id = class_model.id();
     if (!cls->isCompleteDefinition()) {
@@ -1917,47 +1924,32 @@ void translation_unit_visitor::add_incomplete_forward_declarations()
 
 void translation_unit_visitor::resolve_local_to_global_ids()
 {
-    // TODO: Refactor to a map with relationships attached to references
-    //       to elements
-    for (const auto &cls : diagram().classes()) {
-        for (auto &rel : cls.get().relationships()) {
-            if (!rel.destination().is_global()) {
-                const auto maybe_id =
-                    id_mapper().get_global_id(rel.destination());
-                if (maybe_id) {
-                    LOG_DBG("= Resolved instantiation destination from local "
-                            "id {} to global id {}",
-                        rel.destination(), *maybe_id);
-                    rel.set_destination(*maybe_id);
-                }
-            }
+    for (const auto id : visited_element_ids_) {
+        if (auto cls = diagram().find<class_>(id); cls) {
+            resolve_local_to_global_ids(cls.value());
         }
-    }
-    for (const auto &cpt : diagram().concepts()) {
-        for (auto &rel : cpt.get().relationships()) {
-            if (!rel.destination().is_global()) {
-                const auto maybe_id =
-                    id_mapper().get_global_id(rel.destination());
-                if (maybe_id) {
-                    LOG_DBG("= Resolved instantiation destination from local "
-                            "id {} to global id {}",
-                        rel.destination(), *maybe_id);
-                    rel.set_destination(*maybe_id);
-                }
-            }
+        else if (auto cpt = diagram().find<concept_>(id); cpt) {
+            resolve_local_to_global_ids(cpt.value());
+        }
+        else if (auto enm = diagram().find<enum_>(id); enm) {
+            resolve_local_to_global_ids(enm.value());
         }
     }
-    for (const auto &enm : diagram().enums()) {
-        for (auto &rel : enm.get().relationships()) {
-            if (!rel.destination().is_global()) {
-                const auto maybe_id =
-                    id_mapper().get_global_id(rel.destination());
-                if (maybe_id) {
-                    LOG_DBG("= Resolved instantiation destination from local "
-                            "id {} to global id {}",
-                        rel.destination(), *maybe_id);
-                    rel.set_destination(*maybe_id);
-                }
+
+    visited_element_ids_.clear();
+}
+
+void translation_unit_visitor::resolve_local_to_global_ids(
+    common::model::diagram_element &e) const
+{
+    for (auto &rel : e.relationships()) {
+        if (!rel.destination().is_global()) {
+            const auto maybe_id = id_mapper().get_global_id(rel.destination());
+            if (maybe_id) {
+                LOG_DBG("= Resolved instantiation destination from local "
+                        "id {} to global id {}",
+                    rel.destination(), *maybe_id);
+                rel.set_destination(*maybe_id);
             }
         }
     }
@@ -1967,8 +1959,14 @@ void translation_unit_visitor::finalize()
 {
     add_incomplete_forward_declarations();
     resolve_local_to_global_ids();
-    if (config().skip_redundant_dependencies()) {
-        diagram().remove_redundant_dependencies();
+}
+
+void translation_unit_visitor::finalize_diagram(
+    clanguml::class_diagram::model::diagram &diagram,
+    const clanguml::config::class_diagram &config)
+{
+    if (config.skip_redundant_dependencies()) {
+        diagram.remove_redundant_dependencies();
     }
 }
 
@@ -2019,6 +2017,8 @@ void translation_unit_visitor::add_diagram_element(
 
 void translation_unit_visitor::add_class(std::unique_ptr<class_> &&c)
 {
+    visited_element_ids_.emplace(c->id());
+
     if ((config().generate_packages() &&
             config().package_type() == config::package_type_t::kDirectory)) {
         assert(!c->file().empty());
@@ -2047,6 +2047,8 @@ void translation_unit_visitor::add_class(std::unique_ptr<class_> &&c)
 
 void translation_unit_visitor::add_enum(std::unique_ptr<enum_> &&e)
 {
+    visited_element_ids_.emplace(e->id());
+
     if ((config().generate_packages() &&
             config().package_type() == config::package_type_t::kDirectory)) {
         assert(!e->file().empty());
@@ -2075,6 +2077,8 @@ void translation_unit_visitor::add_enum(std::unique_ptr<enum_> &&e)
 
 void translation_unit_visitor::add_concept(std::unique_ptr<concept_> &&c)
 {
+    visited_element_ids_.emplace(c->id());
+
     if ((config().generate_packages() &&
             config().package_type() == config::package_type_t::kDirectory)) {
         assert(!c->file().empty());
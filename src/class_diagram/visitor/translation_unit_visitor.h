@@ -34,6 +34,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_set>
 
 namespace clanguml::class_diagram::visitor {
 
@@ -122,6 +123,16 @@ public:
      */
     void finalize();
 
+    /**
+     * @brief Finalize diagram model once all translation units are visited
+     *
+     * @param diagram Reference to the diagram model
+     * @param config Reference to the diagram configuration
+     */
+    static void finalize_diagram(
+        clanguml::class_diagram::model::diagram &diagram,
+        const clanguml::config::class_diagram &config);
+
     /**
      * @brief Add class (or template class) to the diagram.
      *
@@ -372,9 +383,20 @@ private:
      * traversal of the AST. In such cases, a local id (obtained from `getID()`)
      * and at after the traversal is complete, the id is replaced with the
      * global diagram id.
+     *
+     * Only elements added or updated in the current translation unit are
+     * processed, as AST local ids are only valid within a single translation
+     * unit.
      */
     void resolve_local_to_global_ids();
 
+    /**
+     * @brief Replace AST local ids in relationships of a single element
+     *
+     * @param e Diagram element
+     */
+    void resolve_local_to_global_ids(common::model::diagram_element &e) const;
+
     /**
      * @brief Process concept constraint requirements
      *
@@ -450,5 +472,11 @@ private:
      * @todo There must be a better way to do this...
      */
     std::set<std::string> processed_template_qualified_names_;
+
+    /**
+     * Ids of diagram elements added or updated in this translation unit,
+     * whose relationships can contain AST local ids
+     */
+    std::unordered_set<eid_t> visited_element_ids_;
 };
 } // namespace clanguml::class_diagram::visitor
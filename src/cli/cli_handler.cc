@@ -28,6 +28,9 @@
 #include <clang/Config/config.h>
 #include <indicators/indicators.hpp>
 
+#include <algorithm>
+#include <thread>
+
 namespace clanguml::cli {
 cli_handler::cli_handler(
     std::ostream &ostr, std::shared_ptr<spdlog::logger> logger)
@@ -38,9 +41,7 @@ cli_handler::cli_handler(
 
 void cli_handler::setup_logging()
 {
-    spdlog::drop("clanguml-logger");
-
-    spdlog::register_logger(logger_);
+    util::register_logger(logger_);
 
     logger_->set_pattern("[%^%l%^] [tid %t] %v");
 
@@ -79,6 +80,9 @@ cli_flow_t cli_handler::parse(int argc, const char **argv)
         "Override output directory specified in config file");
     app.add_option("-t,--thread-count", thread_count,
         "Thread pool size (0 = hardware concurrency)");
+    app.add_option("--tu-thread-count", tu_thread_count,
+        "Number of threads visiting translation units of a single diagram "
+        "(default: 1, with --shared-ast: thread count)");
     app.add_flag("-V,--version", show_version, "Print version and exit");
     app.add_flag("-v,--verbose", verbose,
         "Verbose logging (use multiple times to increase - e.g. -vvv)");
@@ -133,6 +137,16 @@ cli_flow_t cli_handler::parse(int argc, const char **argv)
         "Perform configuration file schema validation and exit");
     app.add_flag("-r,--render_diagrams", render_diagrams,
         "Automatically render generated diagrams using appropriate command");
+    app.add_option("--render-thread-count", render_thread_count,
+        "Maximum number of concurrently running diagram render commands "
+        "(default: thread count)");
+    app.add_flag("--shared-ast", shared_ast,
+        "Parse each translation unit only once and visit it with all "
+        "diagrams which include it");
+    app.add_option("--cache-directory", cache_directory,
+        "Skip whole diagrams whose configuration, compile commands and source "
+        "files did not change since they were last generated with the same "
+        "cache directory");
     app.add_option("--plantuml-cmd", plantuml_cmd,
         "Command template to render PlantUML diagram, `{}` will be replaced "
         "with diagram name.");
@@ -188,13 +202,11 @@ cli_flow_t cli_handler::handle_options(int argc, const char **argv)
     config.inherit();
 
     if (progress) {
-        spdlog::drop("clanguml-logger");
-
         // Setup null logger for clean progress indicators
         std::vector<spdlog::sink_ptr> sinks;
         logger_ = std::make_shared<spdlog::logger>(
-            "clanguml-logger", begin(sinks), end(sinks));
-        spdlog::register_logger(logger_);
+            util::kLoggerName, begin(sinks), end(sinks));
+        util::register_logger(logger_);
     }
 
     return res;
@@ -274,7 +286,7 @@ cli_flow_t cli_handler::load_config()
         return cli_flow_t::kContinue;
     }
     catch (std::runtime_error &e) {
-        LOG_ERROR(e.what());
+        LOG_ERROR("{}", e.what());
     }
 
     return cli_flow_t::kError;
@@ -383,12 +395,32 @@ runtime_config cli_handler::get_runtime_config() const
     cfg.print_to = print_to;
     cfg.progress = progress;
     cfg.thread_count = thread_count;
+    if (tu_thread_count)
+        cfg.tu_thread_count = *tu_thread_count;
+    else if (shared_ast)
+        // When translation units are parsed only once, they are by default
+        // visited using all threads
+        cfg.tu_thread_count = effective_thread_count();
     cfg.render_diagrams = render_diagrams;
+    cfg.render_thread_count =
+        render_thread_count.value_or(effective_thread_count());
+    cfg.shared_ast = shared_ast;
     cfg.output_directory = effective_output_directory;
+    if (cache_directory)
+        cfg.cache_directory =
+            util::ensure_path_is_absolute(cache_directory.value()).string();
 
     return cfg;
 }
 
+unsigned int cli_handler::effective_thread_count() const
+{
+    if (thread_count > 0)
+        return thread_count;
+
+    return std::max(std::thread::hardware_concurrency(), 1U);
+}
+
 void cli_handler::set_config_path(const std::string &path)
 {
     config_path = path;
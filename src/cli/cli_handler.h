@@ -37,8 +37,12 @@ struct runtime_config {
     bool print_to{};
     bool progress{};
     unsigned int thread_count{};
+    unsigned int tu_thread_count{1};
     bool render_diagrams{};
+    unsigned int render_thread_count{1};
+    bool shared_ast{};
     std::string output_directory{};
+    std::string cache_directory{};
 };
 
 /**
@@ -153,6 +157,13 @@ public:
      */
     runtime_config get_runtime_config() const;
 
+    /**
+     * @brief Get the size of the thread pool
+     *
+     * @return Value of `--thread-count` or the number of hardware threads
+     */
+    unsigned int effective_thread_count() const;
+
     /**
      * @brief Set the default config path
      *
@@ -166,6 +177,7 @@ public:
     std::optional<std::string> output_directory{};
     std::string effective_output_directory{};
     unsigned int thread_count{};
+    std::optional<unsigned int> tu_thread_count{};
     bool show_version{false};
     int verbose{};
     bool progress{false};
@@ -196,6 +208,9 @@ public:
     bool no_validate{false};
     bool validate_only{false};
     bool render_diagrams{false};
+    std::optional<unsigned int> render_thread_count{};
+    bool shared_ast{false};
+    std::optional<std::string> cache_directory;
     std::optional<std::string> plantuml_cmd;
     std::optional<std::string> mermaid_cmd;
 
@@ -20,6 +20,11 @@
 
 #include <clang/Lex/Preprocessor.h>
 
+#if defined(CLANG_UML_CHECK_ID_COLLISIONS)
+#include <mutex>
+#include <unordered_map>
+#endif
+
 namespace clanguml::common {
 
 model::access_t access_specifier_to_access_t(
@@ -415,10 +420,33 @@ bool is_subexpr_of(const clang::Stmt *parent_stmt, const clang::Stmt *sub_stmt)
         [sub_stmt](const auto *e) { return is_subexpr_of(e, sub_stmt); });
 }
 
+#if defined(CLANG_UML_CHECK_ID_COLLISIONS)
+namespace {
+void check_id_collision(uint64_t id, const std::string &full_name)
+{
+    static std::mutex mutex;
+    static std::unordered_map<uint64_t, std::string> names;
+
+    std::lock_guard<std::mutex> l(mutex);
+
+    const auto [it, inserted] = names.emplace(id, full_name);
+    if (!inserted && it->second != full_name) {
+        LOG_ERROR("Element id collision: '{}' and '{}' have the same id {}",
+            it->second, full_name, id);
+    }
+}
+} // namespace
+#endif
+
 template <> eid_t to_id(const std::string &full_name)
 {
-    return static_cast<eid_t>(
-        static_cast<uint64_t>(std::hash<std::string>{}(full_name)));
+    const auto id = util::hash64(full_name);
+
+#if defined(CLANG_UML_CHECK_ID_COLLISIONS)
+    check_id_collision(id, full_name);
+#endif
+
+    return static_cast<eid_t>(id);
 }
 
 eid_t to_id(const clang::QualType &type, const clang::ASTContext &ctx)
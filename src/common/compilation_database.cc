@@ -113,26 +113,12 @@ void compilation_database::adjust_compilation_database(
                 ? compile_command.CommandLine.at(0)
                 : config().query_driver();
 
-            util::query_driver_output_extractor extractor{
-                argv0, guess_language_from_filename(compile_command.Filename)};
-
-            extractor.execute();
-
-            std::vector<std::string> system_header_args;
-            for (const auto &path : extractor.system_include_paths()) {
-                system_header_args.emplace_back("-isystem");
-                system_header_args.emplace_back(path);
-            }
+            const auto &flags = query_driver_flags(
+                argv0, guess_language_from_filename(compile_command.Filename));
 
             compile_command.CommandLine.insert(
-                compile_command.CommandLine.begin() + 1,
-                system_header_args.begin(), system_header_args.end());
-
-            if (!extractor.target().empty()) {
-                compile_command.CommandLine.insert(
-                    compile_command.CommandLine.begin() + 1,
-                    fmt::format("--target={}", extractor.target()));
-            }
+                compile_command.CommandLine.begin() + 1, flags.begin(),
+                flags.end());
         }
     }
 #endif
@@ -158,4 +144,37 @@ void compilation_database::adjust_compilation_database(
     }
 }
 
+const std::vector<std::string> &compilation_database::query_driver_flags(
+    const std::string &driver, const std::string &language) const
+{
+    // Compile commands can be requested concurrently from multiple
+    // translation unit threads, and the driver should be executed only
+    // once for each key, so the lock is held during the execution
+    std::lock_guard<std::mutex> l(query_driver_flags_mutex_);
+
+    auto key = std::make_pair(driver, language);
+
+    if (auto it = query_driver_flags_.find(key);
+        it != query_driver_flags_.end())
+        return it->second;
+
+    util::query_driver_output_extractor extractor{driver, language};
+
+    extractor.execute();
+
+    std::vector<std::string> flags;
+
+    if (!extractor.target().empty()) {
+        flags.emplace_back(fmt::format("--target={}", extractor.target()));
+    }
+
+    for (const auto &path : extractor.system_include_paths()) {
+        flags.emplace_back("-isystem");
+        flags.emplace_back(path);
+    }
+
+    return query_driver_flags_.emplace(std::move(key), std::move(flags))
+        .first->second;
+}
+
 } // namespace clanguml::common
\ No newline at end of file
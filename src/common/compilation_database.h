@@ -31,6 +31,8 @@
 
 #include <deque>
 #include <filesystem>
+#include <map>
+#include <mutex>
 #include <string>
 
 namespace clanguml::common {
@@ -109,6 +111,19 @@ private:
     void adjust_compilation_database(
         std::vector<clang::tooling::CompileCommand> &commands) const;
 
+    /**
+     * @brief Get compiler flags extracted from the compiler driver output
+     *
+     * The compiler driver is executed only once for each driver and
+     * language pair, subsequent calls return the memoized result.
+     *
+     * @param driver Compiler driver command
+     * @param language Language name to query for (C or C++)
+     * @return Flags to add after argv[0] in compile commands
+     */
+    const std::vector<std::string> &query_driver_flags(
+        const std::string &driver, const std::string &language) const;
+
     /*!
      * Pointer to the Clang's original compilation database.
      *
@@ -121,6 +136,15 @@ private:
      * Reference to the instance of clanguml config.
      */
     const clanguml::config::config &config_;
+
+    /*!
+     * Memoized compiler driver flags, keyed by driver and language.
+     */
+    mutable std::map<std::pair<std::string, std::string>,
+        std::vector<std::string>>
+        query_driver_flags_;
+
+    mutable std::mutex query_driver_flags_mutex_;
 };
 
 using compilation_database_ptr = std::unique_ptr<compilation_database>;
@@ -0,0 +1,237 @@
+/**
+ * @file src/common/generators/diagram_renderer.cc
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "diagram_renderer.h"
+
+#include "util/util.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cctype>
+#include <iterator>
+#include <string_view>
+
+namespace clanguml::common::generators {
+
+namespace {
+// Limits the length of the command line of a single PlantUML invocation
+constexpr std::size_t kMaxBatchSize{32};
+
+constexpr std::string_view kPlaceholder{"{}"};
+
+std::size_t count_placeholders(const std::string &cmd)
+{
+    std::size_t result{0};
+    for (auto pos = cmd.find(kPlaceholder); pos != std::string::npos;
+         pos = cmd.find(kPlaceholder, pos + kPlaceholder.size()))
+        result++;
+
+    return result;
+}
+
+bool is_word_separator(char c, char &quote)
+{
+    if (quote != 0) {
+        if (c == quote)
+            quote = 0;
+        return false;
+    }
+
+    if (c == '"' || c == '\'') {
+        quote = c;
+        return false;
+    }
+
+    return std::isspace(static_cast<unsigned char>(c)) != 0;
+}
+
+bool execute(const std::string &command, std::string &error)
+{
+    try {
+        util::check_process_output(command);
+    }
+    catch (const std::exception &e) {
+        error = e.what();
+        return false;
+    }
+
+    return true;
+}
+} // namespace
+
+diagram_renderer::diagram_renderer(unsigned int concurrency)
+    : executor_{std::max(1U, concurrency)}
+{
+}
+
+bool diagram_renderer::add(generator_type_t generator_type,
+    const std::shared_ptr<config::diagram> &diagram,
+    std::function<void(bool)> on_done)
+{
+    std::string cmd;
+    switch (generator_type) {
+    case generator_type_t::plantuml:
+        cmd = diagram->puml().cmd;
+        break;
+    case generator_type_t::mermaid:
+        cmd = diagram->mermaid().cmd;
+        break;
+    default:
+        return false;
+    };
+
+    if (cmd.empty())
+        throw std::runtime_error(
+            fmt::format("No render command template provided for {} diagrams",
+                to_string(diagram->type())));
+
+    batch_key_t key{generator_type, std::move(cmd)};
+
+    std::lock_guard<std::mutex> l(mutex_);
+
+    queued_[key].push_back({diagram->name, std::move(on_done)});
+
+    // Diagrams queued while all render threads are busy are rendered in
+    // batches by the first of these tasks to run, the remaining tasks find
+    // no diagrams left to render
+    futs_.emplace_back(executor_.add([this, key]() { render(key); }));
+
+    return true;
+}
+
+void diagram_renderer::wait()
+{
+    std::vector<std::future<void>> futs;
+    {
+        std::lock_guard<std::mutex> l(mutex_);
+        futs = std::move(futs_);
+        futs_.clear();
+    }
+
+    executor_.wait(futs);
+}
+
+std::string diagram_renderer::make_batch_command(
+    const std::string &cmd, const std::vector<std::string> &names)
+{
+    const auto pos = cmd.find(kPlaceholder);
+    assert(pos != std::string::npos);
+
+    char quote{0};
+
+    std::size_t word_begin{0};
+    for (auto i = 0U; i < pos; i++) {
+        if (is_word_separator(cmd[i], quote))
+            word_begin = i + 1;
+    }
+
+    auto word_end = pos;
+    while (word_end < cmd.size() && !is_word_separator(cmd[word_end], quote))
+        word_end++;
+
+    const auto word = cmd.substr(word_begin, word_end - word_begin);
+
+    std::vector<std::string> words;
+    for (const auto &name : names) {
+        auto w = word;
+        util::replace_all(w, std::string{kPlaceholder}, name);
+        words.emplace_back(std::move(w));
+    }
+
+    return fmt::format("{}{}{}", cmd.substr(0, word_begin),
+        fmt::join(words, " "), cmd.substr(word_end));
+}
+
+void diagram_renderer::render(const batch_key_t &key)
+{
+    const auto &[generator_type, cmd] = key;
+
+    const auto batch_size = generator_type == generator_type_t::plantuml &&
+            count_placeholders(cmd) == 1
+        ? kMaxBatchSize
+        : 1U;
+
+    std::vector<request> batch;
+    {
+        std::lock_guard<std::mutex> l(mutex_);
+        auto it = queued_.find(key);
+        if (it == queued_.end())
+            return;
+
+        auto &requests = it->second;
+        const auto count = std::min(batch_size, requests.size());
+
+        std::move(requests.begin(), requests.begin() + count,
+            std::back_inserter(batch));
+        requests.erase(requests.begin(), requests.begin() + count);
+
+        if (requests.empty())
+            queued_.erase(it);
+    }
+
+    std::vector<std::string> names;
+    std::transform(batch.begin(), batch.end(), std::back_inserter(names),
+        [](const auto &r) { return r.name; });
+
+    std::string command{cmd};
+    if (names.size() == 1)
+        util::replace_all(command, std::string{kPlaceholder}, names.front());
+    else
+        command = make_batch_command(cmd, names);
+
+    LOG_INFO("Rendering diagrams {} using {}", fmt::join(names, ", "),
+        to_string(generator_type));
+
+    std::string error;
+    if (execute(command, error)) {
+        for (const auto &r : batch) {
+            if (r.on_done)
+                r.on_done(true);
+        }
+        return;
+    }
+
+    if (batch.size() == 1) {
+        LOG_ERROR(
+            "ERROR: Failed to render diagram {}: {}", names.front(), error);
+
+        if (batch.front().on_done)
+            batch.front().on_done(false);
+        return;
+    }
+
+    // A single invalid diagram fails the whole batch, so render the
+    // diagrams separately to report only the diagrams which failed
+    LOG_WARN("Failed to render diagrams {} in a single batch, rendering them "
+             "separately: {}",
+        fmt::join(names, ", "), error);
+
+    for (const auto &r : batch) {
+        command = cmd;
+        util::replace_all(command, std::string{kPlaceholder}, r.name);
+
+        const auto success = execute(command, error);
+        if (!success)
+            LOG_ERROR("ERROR: Failed to render diagram {}: {}", r.name, error);
+
+        if (r.on_done)
+            r.on_done(success);
+    }
+}
+
+} // namespace clanguml::common::generators
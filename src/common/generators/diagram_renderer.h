@@ -0,0 +1,113 @@
+/**
+ * @file src/common/generators/diagram_renderer.h
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "common/types.h"
+#include "config/config.h"
+#include "util/thread_pool_executor.h"
+
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace clanguml::common::generators {
+
+/**
+ * @brief Renders generated diagrams to images using external commands
+ *
+ * Rendering commands are executed asynchronously on a separate thread pool,
+ * so that rendering does not block diagram generation, and the number of
+ * concurrently running rendering processes is limited independently of the
+ * number of diagram generation threads.
+ *
+ * PlantUML accepts many input files in a single invocation, so PlantUML
+ * diagrams queued with the same command template, with a single `{}`
+ * placeholder, are rendered in batches, in order to avoid starting the JVM
+ * for each diagram. When rendering a batch fails, its diagrams are rendered
+ * again one by one, so that only the invalid diagrams are reported as failed.
+ */
+class diagram_renderer {
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param concurrency Maximum number of concurrently executed commands
+     */
+    explicit diagram_renderer(unsigned int concurrency);
+
+    /**
+     * @brief Queue rendering of a generated diagram
+     *
+     * @param generator_type Type of generator, which generated the diagram
+     * @param diagram Diagram configuration
+     * @param on_done Called with the result of the rendering command, after
+     *                it has finished
+     * @return True, if the diagram was queued, false if diagrams generated
+     *         by `generator_type` are not rendered
+     */
+    bool add(generator_type_t generator_type,
+        const std::shared_ptr<config::diagram> &diagram,
+        std::function<void(bool)> on_done = {});
+
+    /**
+     * @brief Wait until all queued diagrams are rendered
+     */
+    void wait();
+
+    /**
+     * @brief Make a command rendering a batch of diagrams
+     *
+     * The shell word of `cmd` containing the `{}` placeholder is repeated
+     * for each diagram, e.g. `plantuml -tsvg "docs/{}.puml"` becomes
+     * `plantuml -tsvg "docs/A.puml" "docs/B.puml"`.
+     *
+     * @param cmd Command template with exactly one `{}` placeholder
+     * @param names Names of the diagrams to render
+     * @return Command rendering all diagrams
+     */
+    static std::string make_batch_command(
+        const std::string &cmd, const std::vector<std::string> &names);
+
+private:
+    using batch_key_t = std::pair<generator_type_t, std::string>;
+
+    struct request {
+        std::string name;
+        std::function<void(bool)> on_done;
+    };
+
+    /**
+     * @brief Render all diagrams queued with the same generator and command
+     *
+     * @param key Generator type and command template
+     */
+    void render(const batch_key_t &key);
+
+    std::mutex mutex_;
+    std::map<batch_key_t, std::vector<request>> queued_;
+    std::vector<std::future<void>> futs_;
+
+    util::thread_pool_executor executor_;
+};
+
+} // namespace clanguml::common::generators
@@ -0,0 +1,339 @@
+/**
+ * @file src/common/generators/diagram_skip_cache.cc
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "diagram_skip_cache.h"
+
+#include "util/util.h"
+#include "version.h"
+
+#include <array>
+#include <fstream>
+
+namespace clanguml::common::generators {
+
+namespace {
+std::string hash_to_string(std::uint64_t hash)
+{
+    return fmt::format("{:016x}", hash);
+}
+
+std::string hash_string(std::string_view data)
+{
+    return hash_to_string(util::hash64(data));
+}
+
+std::optional<std::string> hash_file(const std::filesystem::path &path)
+{
+    std::ifstream ifs{path, std::ios::binary};
+    if (!ifs)
+        return {};
+
+    std::uint64_t hash{0};
+    std::array<char, 64 * 1024> buffer{};
+    while (ifs) {
+        ifs.read(buffer.data(), buffer.size());
+        hash = util::hash64(
+            std::string_view{buffer.data(), static_cast<size_t>(ifs.gcount())},
+            hash);
+    }
+
+    return hash_to_string(hash);
+}
+
+std::string hash_compile_commands(
+    const common::compilation_database &db, const std::string &file)
+{
+    std::string commands;
+    for (const auto &command : db.getCompileCommands(file)) {
+        commands += command.Directory;
+        commands += '\0';
+        commands += command.Filename;
+        for (const auto &arg : command.CommandLine) {
+            commands += '\0';
+            commands += arg;
+        }
+        commands += '\n';
+    }
+
+    return hash_string(commands);
+}
+} // namespace
+
+std::optional<std::string> file_hashes::get(const std::string &file)
+{
+    {
+        std::lock_guard<std::mutex> l(mutex_);
+        if (auto it = hashes_.find(file); it != hashes_.end())
+            return it->second;
+    }
+
+    // Hash the file without holding the lock, if more threads hash the same
+    // file at the same time, the first hash is kept
+    auto hash = hash_file(file);
+
+    std::lock_guard<std::mutex> l(mutex_);
+    return hashes_.try_emplace(file, std::move(hash)).first->second;
+}
+
+translation_unit_dependencies::collector::collector(
+    translation_unit_dependencies &dependencies, std::string translation_unit,
+    std::filesystem::path working_directory)
+    : dependencies_{dependencies}
+    , translation_unit_{std::move(translation_unit)}
+    , working_directory_{std::move(working_directory)}
+{
+}
+
+bool translation_unit_dependencies::collector::sawDependency(
+    llvm::StringRef filename, bool from_module, bool is_system,
+    bool is_module_file, bool is_missing)
+{
+    if (is_missing ||
+        !clang::DependencyCollector::sawDependency(
+            filename, from_module, is_system, is_module_file, is_missing))
+        return false;
+
+    std::filesystem::path path{filename.str()};
+    if (path.is_relative())
+        path = working_directory_ / path;
+
+    // The file has just been read by the preprocessor, so hash it now
+    // rather than after all translation units have been processed
+    dependencies_.add(translation_unit_, path.lexically_normal().string());
+
+    // The dependencies are stored in `dependencies_`, not in the collector
+    return false;
+}
+
+translation_unit_dependencies::translation_unit_dependencies(
+    file_hashes &hashes)
+    : hashes_{hashes}
+{
+}
+
+void translation_unit_dependencies::attach(
+    clang::CompilerInstance &ci, const std::string &translation_unit)
+{
+    // Relative dependency paths are resolved against the working directory
+    // of the compile command, which is only set during the Clang tool run
+    std::filesystem::path working_directory;
+    if (auto cwd = ci.getVirtualFileSystem().getCurrentWorkingDirectory(); cwd)
+        working_directory = cwd.get();
+
+    auto c = std::make_shared<collector>(
+        *this, translation_unit, std::move(working_directory));
+    c->attachToPreprocessor(ci.getPreprocessor());
+
+    // The preprocessor already exists, so the compiler instance only keeps
+    // the collector alive until the translation unit has been processed
+    ci.addDependencyCollector(std::move(c));
+
+    add(translation_unit, translation_unit);
+}
+
+void translation_unit_dependencies::add(
+    const std::string &translation_unit, const std::string &file)
+{
+    if (!hashes_.get(file))
+        return;
+
+    std::lock_guard<std::mutex> l(mutex_);
+    files_[translation_unit].emplace(file);
+}
+
+std::map<std::string, std::string> translation_unit_dependencies::get(
+    const std::string &translation_unit) const
+{
+    std::set<std::string> files;
+    {
+        std::lock_guard<std::mutex> l(mutex_);
+        if (auto it = files_.find(translation_unit); it != files_.end())
+            files = it->second;
+    }
+
+    std::map<std::string, std::string> result;
+    for (const auto &file : files) {
+        if (auto hash = hashes_.get(file); hash)
+            result.emplace(file, std::move(*hash));
+    }
+
+    return result;
+}
+
+diagram_skip_cache::diagram_cache(std::filesystem::path directory)
+    : directory_{std::move(directory)}
+{
+}
+
+std::string diagram_skip_cache::make_key(
+    const config::diagram &diagram, const cli::runtime_config &runtime_config)
+{
+    using common::model::diagram_t;
+
+    YAML::Emitter out;
+    out << YAML::BeginMap;
+    out << YAML::Key << "version" << YAML::Value
+        << version::CLANG_UML_VERSION;
+    out << YAML::Key << "diagram" << YAML::Value;
+    if (diagram.type() == diagram_t::kClass) {
+        out << dynamic_cast<const config::class_diagram &>(diagram);
+    }
+    else if (diagram.type() == diagram_t::kSequence) {
+        out << dynamic_cast<const config::sequence_diagram &>(diagram);
+    }
+    else if (diagram.type() == diagram_t::kInclude) {
+        out << dynamic_cast<const config::include_diagram &>(diagram);
+    }
+    else if (diagram.type() == diagram_t::kPackage) {
+        out << dynamic_cast<const config::package_diagram &>(diagram);
+    }
+    out << YAML::Key << "generators" << YAML::Value << YAML::BeginSeq;
+    for (const auto generator : runtime_config.generators)
+        out << to_string(generator);
+    out << YAML::EndSeq;
+    out << YAML::Key << "output_directory" << YAML::Value
+        << runtime_config.output_directory;
+    out << YAML::Key << "render_diagrams" << YAML::Value
+        << runtime_config.render_diagrams;
+    out << YAML::EndMap;
+
+    return hash_string(out.c_str());
+}
+
+bool diagram_skip_cache::is_up_to_date(const std::string &name,
+    const std::string &key, const common::compilation_database &db,
+    const std::vector<std::string> &translation_units,
+    const std::vector<std::filesystem::path> &outputs) const
+{
+    const auto path = cache_file_path(name);
+
+    if (!std::filesystem::exists(path))
+        return false;
+
+    for (const auto &output : outputs) {
+        if (!std::filesystem::exists(output)) {
+            LOG_DBG("Diagram {} output {} does not exist", name,
+                output.string());
+            return false;
+        }
+    }
+
+    try {
+        const auto node = YAML::LoadFile(path.string());
+
+        if (node["key"].as<std::string>() != key) {
+            LOG_DBG("Diagram {} configuration changed", name);
+            return false;
+        }
+
+        const auto &tus_node = node["translation_units"];
+        if (tus_node.size() != translation_units.size())
+            return false;
+
+        for (auto i = 0U; i < translation_units.size(); i++) {
+            const auto &tu_node = tus_node[i];
+            const auto &translation_unit = translation_units[i];
+
+            if (tu_node["file"].as<std::string>() != translation_unit ||
+                tu_node["command"].as<std::string>() !=
+                    hash_compile_commands(db, translation_unit)) {
+                LOG_DBG("Translation unit {} of diagram {} changed",
+                    translation_unit, name);
+                return false;
+            }
+
+            for (const auto &dependency : tu_node["dependencies"]) {
+                const auto file = dependency["file"].as<std::string>();
+                if (hashes_.get(file) !=
+                    dependency["hash"].as<std::string>()) {
+                    LOG_DBG("File {} of translation unit {} changed", file,
+                        translation_unit);
+                    return false;
+                }
+            }
+        }
+    }
+    catch (const YAML::Exception &e) {
+        LOG_WARN("Invalid diagram cache file {}: {}", path.string(), e.what());
+        return false;
+    }
+
+    return true;
+}
+
+void diagram_skip_cache::update(const std::string &name, const std::string &key,
+    const common::compilation_database &db,
+    const std::vector<std::string> &translation_units,
+    const translation_unit_dependencies &dependencies) const
+{
+    YAML::Emitter out;
+    out << YAML::BeginMap;
+    out << YAML::Key << "key" << YAML::Value << key;
+    out << YAML::Key << "translation_units" << YAML::Value << YAML::BeginSeq;
+    for (const auto &translation_unit : translation_units) {
+        out << YAML::BeginMap;
+        out << YAML::Key << "file" << YAML::Value << translation_unit;
+        out << YAML::Key << "command" << YAML::Value
+            << hash_compile_commands(db, translation_unit);
+        out << YAML::Key << "dependencies" << YAML::Value << YAML::BeginSeq;
+        for (const auto &[file, hash] : dependencies.get(translation_unit)) {
+            out << YAML::BeginMap;
+            out << YAML::Key << "file" << YAML::Value << file;
+            out << YAML::Key << "hash" << YAML::Value << hash;
+            out << YAML::EndMap;
+        }
+        out << YAML::EndSeq;
+        out << YAML::EndMap;
+    }
+    out << YAML::EndSeq;
+    out << YAML::EndMap;
+
+    const auto path = cache_file_path(name);
+
+    std::filesystem::create_directories(directory_);
+
+    // Write to a temporary file first, so that an interrupted run does
+    // not leave a truncated cache entry
+    auto tmp_path = path;
+    tmp_path += ".tmp";
+    {
+        std::ofstream ofs{tmp_path, std::ofstream::out | std::ofstream::trunc};
+        ofs << out.c_str() << '\n';
+    }
+    std::filesystem::rename(tmp_path, path);
+
+    LOG_DBG("Updated diagram {} cache in {}", name, path.string());
+}
+
+void diagram_skip_cache::invalidate(const std::string &name) const
+{
+    std::error_code ec;
+    std::filesystem::remove(cache_file_path(name), ec);
+
+    LOG_DBG("Invalidated diagram {} cache", name);
+}
+
+file_hashes &diagram_skip_cache::hashes() const { return hashes_; }
+
+std::filesystem::path diagram_skip_cache::cache_file_path(
+    const std::string &name) const
+{
+    return directory_ / fmt::format("{}.yml", name);
+}
+
+} // namespace clanguml::common::generators
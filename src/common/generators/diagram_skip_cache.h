@@ -0,0 +1,221 @@
+/**
+ * @file src/common/generators/diagram_skip_cache.h
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "cli/cli_handler.h"
+#include "common/compilation_database.h"
+#include "config/config.h"
+
+#include <clang/Frontend/CompilerInstance.h>
+#include <clang/Frontend/Utils.h>
+
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace clanguml::common::generators {
+
+/**
+ * @brief Memo of file content hashes
+ *
+ * Each file is read and hashed at most once per run, no matter how many
+ * translation units and diagrams include it. The first hash of each file is
+ * kept, so a file modified during the run is detected as changed in the next
+ * run.
+ */
+class file_hashes {
+public:
+    /**
+     * @brief Get the hash of file contents, hashing the file on first use
+     *
+     * @param file Absolute path of the file
+     * @return Hash of the file contents, if the file could be read
+     */
+    std::optional<std::string> get(const std::string &file);
+
+private:
+    std::mutex mutex_;
+    std::unordered_map<std::string, std::optional<std::string>> hashes_;
+};
+
+/**
+ * @brief Collects all files read while parsing translation units
+ *
+ * The collected files, including system headers, are stored in the diagram
+ * skip cache, in order to detect whether a diagram must be generated again.
+ * Each file is hashed when it is first read by the preprocessor, so that
+ * files modified while the diagrams are generated are not stored in the
+ * cache with hashes of content, which was never parsed.
+ */
+class translation_unit_dependencies {
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param hashes Memo of file hashes shared by all translation units
+     */
+    explicit translation_unit_dependencies(file_hashes &hashes);
+
+    /**
+     * @brief Start collecting dependencies of a translation unit
+     *
+     * This must be called before the preprocessor enters the main file, e.g.
+     * from `BeginSourceFileAction()`.
+     *
+     * @param ci Compiler instance of the translation unit
+     * @param translation_unit Path to the translation unit
+     */
+    void attach(
+        clang::CompilerInstance &ci, const std::string &translation_unit);
+
+    /**
+     * @brief Add file read by a translation unit, hashing its contents
+     *
+     * @param translation_unit Path to the translation unit
+     * @param file Absolute path of the file
+     */
+    void add(const std::string &translation_unit, const std::string &file);
+
+    /**
+     * @brief Get hashes of all files read by a translation unit
+     *
+     * Files which could not be read are not included.
+     *
+     * @param translation_unit Path to the translation unit
+     * @return Map of absolute file paths to hashes of their contents
+     */
+    std::map<std::string, std::string> get(
+        const std::string &translation_unit) const;
+
+private:
+    class collector : public clang::DependencyCollector {
+    public:
+        collector(translation_unit_dependencies &dependencies,
+            std::string translation_unit,
+            std::filesystem::path working_directory);
+
+        bool needSystemDependencies() override { return true; }
+
+        bool sawDependency(llvm::StringRef filename, bool from_module,
+            bool is_system, bool is_module_file, bool is_missing) override;
+
+    private:
+        translation_unit_dependencies &dependencies_;
+        std::string translation_unit_;
+        std::filesystem::path working_directory_;
+    };
+
+    file_hashes &hashes_;
+
+    mutable std::mutex mutex_;
+    // Files read by each translation unit, their hashes are in `hashes_`
+    std::map<std::string, std::set<std::string>> files_;
+};
+
+/**
+ * @brief Persistent cache of diagram inputs, used to skip whole diagrams
+ *
+ * For each generated diagram, the cache stores a file in the cache
+ * directory with a hash of the effective diagram configuration and, for
+ * each translation unit, a hash of its compile commands and the hashes of
+ * all files it includes. If none of these changed since the last run and
+ * all diagram output files still exist, the diagram does not have to be
+ * generated again.
+ *
+ * The cache does not store diagram models, so when any input of a diagram
+ * changes, all translation units of the diagram are parsed again.
+ */
+class diagram_skip_cache {
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param directory Path to the cache directory
+     */
+    explicit diagram_skip_cache(std::filesystem::path directory);
+
+    /**
+     * @brief Calculate the key of diagram configuration and output options
+     *
+     * @param diagram Effective diagram configuration
+     * @param runtime_config Runtime options from the command line
+     * @return Hash of the diagram configuration
+     */
+    static std::string make_key(const config::diagram &diagram,
+        const cli::runtime_config &runtime_config);
+
+    /**
+     * @brief Check whether the diagram can be skipped
+     *
+     * @param name Name of the diagram
+     * @param key Key of the diagram configuration (see make_key())
+     * @param db Reference to compilation database
+     * @param translation_units List of translation units of the diagram
+     * @param outputs List of diagram output files
+     * @return True, if the cached entry matches all inputs and outputs exist
+     */
+    bool is_up_to_date(const std::string &name, const std::string &key,
+        const common::compilation_database &db,
+        const std::vector<std::string> &translation_units,
+        const std::vector<std::filesystem::path> &outputs) const;
+
+    /**
+     * @brief Store the inputs of a successfully generated diagram
+     *
+     * @param name Name of the diagram
+     * @param key Key of the diagram configuration (see make_key())
+     * @param db Reference to compilation database
+     * @param translation_units List of translation units of the diagram
+     * @param dependencies Files read by the translation units
+     */
+    void update(const std::string &name, const std::string &key,
+        const common::compilation_database &db,
+        const std::vector<std::string> &translation_units,
+        const translation_unit_dependencies &dependencies) const;
+
+    /**
+     * @brief Remove the cached entry of a diagram
+     *
+     * This forces generating the diagram again in the next run, e.g. when
+     * rendering the generated diagram failed.
+     *
+     * @param name Name of the diagram
+     */
+    void invalidate(const std::string &name) const;
+
+    /**
+     * @brief Get memo of file hashes used by this cache
+     *
+     * @return Memo of file hashes
+     */
+    file_hashes &hashes() const;
+
+private:
+    std::filesystem::path cache_file_path(const std::string &name) const;
+
+    std::filesystem::path directory_;
+    mutable file_hashes hashes_;
+};
+
+} // namespace clanguml::common::generators
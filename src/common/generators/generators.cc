@@ -20,6 +20,8 @@
 
 #include "progress_indicator.h"
 
+#include <atomic>
+
 namespace clanguml::common::generators {
 void find_translation_units_for_diagrams(
     const std::vector<std::string> &diagram_names,
@@ -57,32 +59,29 @@ void find_translation_units_for_diagrams(
     }
 }
 
-void render_diagram(const clanguml::common::generator_type_t generator_type,
-    std::shared_ptr<config::diagram> diagram_config)
+std::vector<std::vector<std::string>> split_translation_units(
+    const std::vector<std::string> &translation_units, unsigned int shard_count)
 {
-    std::string cmd;
-    switch (generator_type) {
-    case clanguml::common::generator_type_t::plantuml:
-        cmd = diagram_config->puml().cmd;
-        break;
-    case clanguml::common::generator_type_t::mermaid:
-        cmd = diagram_config->mermaid().cmd;
-        break;
-    default:
-        return;
-    };
+    std::vector<std::vector<std::string>> result;
+
+    if (translation_units.empty())
+        return result;
 
-    if (cmd.empty())
-        throw std::runtime_error(
-            fmt::format("No render command template provided for {} diagrams",
-                to_string(diagram_config->type())));
+    shard_count = std::max(1U,
+        std::min(shard_count,
+            static_cast<unsigned int>(translation_units.size())));
 
-    util::replace_all(cmd, "{}", diagram_config->name);
+    const auto shard_size = translation_units.size() / shard_count;
+    const auto remainder = translation_units.size() % shard_count;
 
-    LOG_INFO("Rendering diagram {} using {}", diagram_config->name,
-        to_string(generator_type));
+    auto it = translation_units.begin();
+    for (auto i = 0U; i < shard_count; i++) {
+        const auto size = shard_size + (i < remainder ? 1 : 0);
+        result.emplace_back(it, it + size);
+        it += size;
+    }
 
-    util::check_process_output(cmd);
+    return result;
 }
 
 namespace detail {
@@ -95,38 +94,47 @@ void generate_diagram_select_generator(const std::string &od,
     using diagram_generator =
         typename diagram_generator_t<DiagramConfig, GeneratorTag>::type;
 
-    std::stringstream buffer;
-    buffer << diagram_generator(
-        dynamic_cast<DiagramConfig &>(*diagram), *model);
-
-    // Only open the file after the diagram has been generated successfully
-    // in order not to overwrite previous diagram in case of failure
     auto path = std::filesystem::path{od} /
         fmt::format("{}.{}", name, GeneratorTag::extension);
-    std::ofstream ofs;
-    ofs.open(path, std::ofstream::out | std::ofstream::trunc);
-    ofs << buffer.str();
 
-    ofs.close();
+    // Stream the diagram directly into a temporary file, which replaces
+    // the previous diagram only after it has been generated successfully
+    auto tmp_path = path;
+    tmp_path += ".tmp";
+
+    try {
+        std::ofstream ofs;
+        ofs.open(tmp_path, std::ofstream::out | std::ofstream::trunc);
+        if (!ofs)
+            throw std::runtime_error(
+                fmt::format("Cannot open file {}", tmp_path.string()));
+
+        ofs << diagram_generator(
+            dynamic_cast<DiagramConfig &>(*diagram), *model);
+
+        ofs.close();
+        if (!ofs)
+            throw std::runtime_error(
+                fmt::format("Cannot write file {}", tmp_path.string()));
+    }
+    catch (...) {
+        std::error_code ec;
+        std::filesystem::remove(tmp_path, ec);
+        throw;
+    }
+
+    std::filesystem::rename(tmp_path, path);
 
     LOG_INFO("Written {} diagram to {}", name, path.string());
 }
 
 template <typename DiagramConfig>
-void generate_diagram_impl(const std::string &name,
+void generate_diagram_outputs(const std::string &name,
     std::shared_ptr<clanguml::config::diagram> diagram,
-    const common::compilation_database &db,
-    const std::vector<std::string> &translation_units,
-    const cli::runtime_config &runtime_config, std::function<void()> &&progress)
+    const std::unique_ptr<typename diagram_model_t<DiagramConfig>::type> &model,
+    const cli::runtime_config &runtime_config)
 {
     using diagram_config = DiagramConfig;
-    using diagram_model = typename diagram_model_t<DiagramConfig>::type;
-    using diagram_visitor = typename diagram_visitor_t<DiagramConfig>::type;
-
-    auto model = clanguml::common::generators::generate<diagram_model,
-        diagram_config, diagram_visitor>(db, diagram->name,
-        dynamic_cast<diagram_config &>(*diagram), translation_units,
-        runtime_config.verbose, std::move(progress));
 
     if constexpr (std::is_same_v<DiagramConfig, config::sequence_diagram>) {
         if (runtime_config.print_from) {
@@ -165,21 +173,62 @@ void generate_diagram_impl(const std::string &name,
                 mermaid_generator_tag>(
                 runtime_config.output_directory, name, diagram, model);
         }
-
-        // Convert plantuml or mermaid to an image using command provided
-        // in the command line arguments
-        if (runtime_config.render_diagrams) {
-            render_diagram(generator_type, diagram);
-        }
     }
 }
+
+template <typename DiagramConfig>
+void generate_diagram_impl(const std::string &name,
+    std::shared_ptr<clanguml::config::diagram> diagram,
+    const common::compilation_database &db,
+    const std::vector<std::string> &translation_units,
+    const cli::runtime_config &runtime_config, std::function<void()> &&progress,
+    translation_unit_dependencies *dependencies)
+{
+    using diagram_config = DiagramConfig;
+    using diagram_model = typename diagram_model_t<DiagramConfig>::type;
+    using diagram_visitor = typename diagram_visitor_t<DiagramConfig>::type;
+
+    auto model = clanguml::common::generators::generate<diagram_model,
+        diagram_config, diagram_visitor>(db, diagram->name,
+        dynamic_cast<diagram_config &>(*diagram), translation_units,
+        runtime_config.verbose, std::move(progress),
+        runtime_config.tu_thread_count, dependencies);
+
+    generate_diagram_outputs<DiagramConfig>(
+        name, diagram, model, runtime_config);
+}
+
+template <typename DiagramConfig>
+std::unique_ptr<diagram_model_builder> make_diagram_model_builder(
+    const std::string &name, std::shared_ptr<clanguml::config::diagram> diagram,
+    const std::vector<std::string> &translation_units,
+    std::function<void()> progress)
+{
+    return std::make_unique<diagram_model_builder_t<DiagramConfig>>(name,
+        dynamic_cast<DiagramConfig &>(*diagram), translation_units,
+        std::move(progress));
+}
+
+template <typename DiagramConfig>
+void generate_diagram_outputs_from_builder(const std::string &name,
+    std::shared_ptr<clanguml::config::diagram> diagram,
+    diagram_model_builder &builder, const cli::runtime_config &runtime_config)
+{
+    auto &model =
+        dynamic_cast<diagram_model_builder_t<DiagramConfig> &>(builder)
+            .model();
+
+    generate_diagram_outputs<DiagramConfig>(
+        name, diagram, model, runtime_config);
+}
 } // namespace detail
 
 void generate_diagram(const std::string &name,
     std::shared_ptr<clanguml::config::diagram> diagram,
     const common::compilation_database &db,
     const std::vector<std::string> &translation_units,
-    const cli::runtime_config &runtime_config, std::function<void()> &&progress)
+    const cli::runtime_config &runtime_config, std::function<void()> &&progress,
+    translation_unit_dependencies *dependencies)
 {
     using clanguml::common::generator_type_t;
     using clanguml::common::model::diagram_t;
@@ -191,19 +240,600 @@ void generate_diagram(const std::string &name,
 
     if (diagram->type() == diagram_t::kClass) {
         detail::generate_diagram_impl<class_diagram>(name, diagram, db,
-            translation_units, runtime_config, std::move(progress));
+            translation_units, runtime_config, std::move(progress),
+            dependencies);
     }
     else if (diagram->type() == diagram_t::kSequence) {
         detail::generate_diagram_impl<sequence_diagram>(name, diagram, db,
-            translation_units, runtime_config, std::move(progress));
+            translation_units, runtime_config, std::move(progress),
+            dependencies);
     }
     else if (diagram->type() == diagram_t::kPackage) {
         detail::generate_diagram_impl<package_diagram>(name, diagram, db,
-            translation_units, runtime_config, std::move(progress));
+            translation_units, runtime_config, std::move(progress),
+            dependencies);
     }
     else if (diagram->type() == diagram_t::kInclude) {
         detail::generate_diagram_impl<include_diagram>(name, diagram, db,
-            translation_units, runtime_config, std::move(progress));
+            translation_units, runtime_config, std::move(progress),
+            dependencies);
+    }
+}
+
+bool supports_translation_unit_shards(model::diagram_t diagram_type)
+{
+    using clanguml::common::model::diagram_t;
+
+    switch (diagram_type) {
+    case diagram_t::kClass:
+        return supports_translation_unit_shards_v<
+            diagram_model_t<config::class_diagram>::type>;
+    case diagram_t::kSequence:
+        return supports_translation_unit_shards_v<
+            diagram_model_t<config::sequence_diagram>::type>;
+    case diagram_t::kPackage:
+        return supports_translation_unit_shards_v<
+            diagram_model_t<config::package_diagram>::type>;
+    case diagram_t::kInclude:
+        return supports_translation_unit_shards_v<
+            diagram_model_t<config::include_diagram>::type>;
+    }
+
+    return false;
+}
+
+std::vector<std::filesystem::path> diagram_output_paths(
+    const std::string &name, const cli::runtime_config &runtime_config)
+{
+    std::vector<std::filesystem::path> result;
+
+    for (const auto generator_type : runtime_config.generators) {
+        std::string extension;
+        if (generator_type == generator_type_t::plantuml)
+            extension = plantuml_generator_tag::extension;
+        else if (generator_type == generator_type_t::json)
+            extension = json_generator_tag::extension;
+        else if (generator_type == generator_type_t::mermaid)
+            extension = mermaid_generator_tag::extension;
+
+        result.emplace_back(std::filesystem::path{
+                                runtime_config.output_directory} /
+            fmt::format("{}.{}", name, extension));
+    }
+
+    return result;
+}
+
+std::unique_ptr<diagram_model_builder> make_diagram_model_builder(
+    const std::string &name, std::shared_ptr<clanguml::config::diagram> diagram,
+    const std::vector<std::string> &translation_units,
+    std::function<void()> progress)
+{
+    using clanguml::common::model::diagram_t;
+
+    using clanguml::config::class_diagram;
+    using clanguml::config::include_diagram;
+    using clanguml::config::package_diagram;
+    using clanguml::config::sequence_diagram;
+
+    if (diagram->type() == diagram_t::kClass) {
+        return detail::make_diagram_model_builder<class_diagram>(
+            name, diagram, translation_units, std::move(progress));
+    }
+    if (diagram->type() == diagram_t::kSequence) {
+        return detail::make_diagram_model_builder<sequence_diagram>(
+            name, diagram, translation_units, std::move(progress));
+    }
+    if (diagram->type() == diagram_t::kPackage) {
+        return detail::make_diagram_model_builder<package_diagram>(
+            name, diagram, translation_units, std::move(progress));
+    }
+    if (diagram->type() == diagram_t::kInclude) {
+        return detail::make_diagram_model_builder<include_diagram>(
+            name, diagram, translation_units, std::move(progress));
+    }
+
+    return {};
+}
+
+void generate_diagram_outputs(const std::string &name,
+    std::shared_ptr<clanguml::config::diagram> diagram,
+    diagram_model_builder &builder, const cli::runtime_config &runtime_config)
+{
+    using clanguml::common::model::diagram_t;
+
+    using clanguml::config::class_diagram;
+    using clanguml::config::include_diagram;
+    using clanguml::config::package_diagram;
+    using clanguml::config::sequence_diagram;
+
+    if (diagram->type() == diagram_t::kClass) {
+        detail::generate_diagram_outputs_from_builder<class_diagram>(
+            name, diagram, builder, runtime_config);
+    }
+    else if (diagram->type() == diagram_t::kSequence) {
+        detail::generate_diagram_outputs_from_builder<sequence_diagram>(
+            name, diagram, builder, runtime_config);
+    }
+    else if (diagram->type() == diagram_t::kPackage) {
+        detail::generate_diagram_outputs_from_builder<package_diagram>(
+            name, diagram, builder, runtime_config);
+    }
+    else if (diagram->type() == diagram_t::kInclude) {
+        detail::generate_diagram_outputs_from_builder<include_diagram>(
+            name, diagram, builder, runtime_config);
+    }
+}
+
+shared_ast_fronted_action::shared_ast_fronted_action(
+    std::vector<diagram_model_builder *> builders,
+    translation_unit_dependencies *dependencies)
+    : builders_{std::move(builders)}
+    , dependencies_{dependencies}
+{
+}
+
+std::unique_ptr<clang::ASTConsumer>
+shared_ast_fronted_action::CreateASTConsumer(
+    clang::CompilerInstance &CI, clang::StringRef /*file*/)
+{
+    std::vector<std::unique_ptr<clang::ASTConsumer>> consumers;
+    consumers.reserve(builders_.size());
+
+    for (auto *builder : builders_) {
+        if (builder->requires_ast())
+            consumers.emplace_back(
+                builder->create_ast_consumer(CI, getCurrentFile().str()));
+    }
+
+    return std::make_unique<clang::MultiplexConsumer>(std::move(consumers));
+}
+
+namespace {
+void begin_shared_source_file(clang::CompilerInstance &ci,
+    const std::string &file,
+    const std::vector<diagram_model_builder *> &builders,
+    translation_unit_dependencies *dependencies)
+{
+    LOG_DBG("Visiting source file: {} for {} diagrams", file, builders.size());
+
+    if (dependencies != nullptr)
+        dependencies->attach(ci, file);
+
+    for (auto *builder : builders) {
+        builder->begin_source_file(ci);
+    }
+}
+} // namespace
+
+bool shared_ast_fronted_action::BeginSourceFileAction(
+    clang::CompilerInstance &ci)
+{
+    begin_shared_source_file(
+        ci, getCurrentFile().str(), builders_, dependencies_);
+
+    return true;
+}
+
+shared_preprocessor_fronted_action::shared_preprocessor_fronted_action(
+    std::vector<diagram_model_builder *> builders,
+    translation_unit_dependencies *dependencies)
+    : builders_{std::move(builders)}
+    , dependencies_{dependencies}
+{
+}
+
+bool shared_preprocessor_fronted_action::BeginSourceFileAction(
+    clang::CompilerInstance &ci)
+{
+    begin_shared_source_file(
+        ci, getCurrentFile().str(), builders_, dependencies_);
+
+    return true;
+}
+
+shared_ast_action_factory::shared_ast_action_factory(
+    std::vector<diagram_model_builder *> builders,
+    translation_unit_dependencies *dependencies)
+    : builders_{std::move(builders)}
+    , dependencies_{dependencies}
+{
+}
+
+std::unique_ptr<clang::FrontendAction> shared_ast_action_factory::create()
+{
+    // Skip parsing the translation unit, if it is visited only by diagrams
+    // built from preprocessor callbacks
+    if (std::none_of(builders_.begin(), builders_.end(),
+            [](const auto *b) { return b->requires_ast(); }))
+        return std::make_unique<shared_preprocessor_fronted_action>(
+            builders_, dependencies_);
+
+    return std::make_unique<shared_ast_fronted_action>(
+        builders_, dependencies_);
+}
+
+namespace {
+std::unique_ptr<diagram_skip_cache> make_diagram_skip_cache(
+    const cli::runtime_config &runtime_config)
+{
+    // Printing 'from' and 'to' values does not generate any output files
+    if (runtime_config.cache_directory.empty() || runtime_config.print_from ||
+        runtime_config.print_to)
+        return {};
+
+    return std::make_unique<diagram_skip_cache>(
+        runtime_config.cache_directory);
+}
+
+std::unique_ptr<translation_unit_dependencies>
+make_translation_unit_dependencies(diagram_skip_cache *cache)
+{
+    if (cache == nullptr)
+        return {};
+
+    return std::make_unique<translation_unit_dependencies>(cache->hashes());
+}
+
+std::unique_ptr<diagram_renderer> make_diagram_renderer(
+    const cli::runtime_config &runtime_config)
+{
+    if (!runtime_config.render_diagrams || runtime_config.print_from ||
+        runtime_config.print_to)
+        return {};
+
+    return std::make_unique<diagram_renderer>(
+        runtime_config.render_thread_count);
+}
+
+/**
+ * Convert plantuml or mermaid diagrams to images using commands provided
+ * in the configuration, without waiting for the commands to finish.
+ *
+ * The diagram is marked as complete in the progress indicator only after
+ * all its outputs have been rendered, or as failed if any of the rendering
+ * commands fails.
+ */
+void render_diagram_outputs(diagram_renderer *renderer,
+    const std::string &name,
+    const std::shared_ptr<clanguml::config::diagram> &diagram,
+    const cli::runtime_config &runtime_config, const diagram_skip_cache *cache,
+    progress_indicator *indicator)
+{
+    struct render_state {
+        // Starts at 1, so that the diagram is not finished before all
+        // of its outputs have been queued
+        std::atomic<unsigned> pending{1};
+        std::atomic<bool> failed{false};
+    };
+
+    auto state = std::make_shared<render_state>();
+
+    auto finish = [state, cache, indicator, name]() {
+        if (--state->pending > 0)
+            return;
+
+        if (!state->failed) {
+            if (indicator != nullptr)
+                indicator->complete(name);
+            return;
+        }
+
+        // Make sure the diagram is generated and rendered again in the
+        // next run
+        if (cache != nullptr)
+            cache->invalidate(name);
+
+        if (indicator != nullptr)
+            indicator->fail(name);
+
+        LOG_ERROR("ERROR: Failed to generate diagram {}: rendering failed",
+            name);
+    };
+
+    if (renderer != nullptr) {
+        for (const auto generator_type : runtime_config.generators) {
+            state->pending++;
+            if (!renderer->add(
+                    generator_type, diagram, [state, finish](bool success) {
+                        if (!success)
+                            state->failed = true;
+                        finish();
+                    }))
+                state->pending--;
+        }
+    }
+
+    finish();
+}
+} // namespace
+
+void generate_diagrams_shared_ast(const std::vector<std::string> &diagram_names,
+    config::config &config, const common::compilation_database_ptr &db,
+    const cli::runtime_config &runtime_config,
+    const std::map<std::string, std::vector<std::string>>
+        &translation_units_map)
+{
+    util::thread_pool_executor generator_executor{runtime_config.thread_count};
+    std::vector<std::future<void>> futs;
+
+    std::unique_ptr<progress_indicator> indicator;
+
+    if (runtime_config.progress) {
+        std::cout << termcolor::white
+                  << "Processing translation units and generating diagrams:\n";
+        indicator = std::make_unique<progress_indicator>();
+    }
+
+    const auto cache = make_diagram_skip_cache(runtime_config);
+    const auto renderer = make_diagram_renderer(runtime_config);
+    const auto dependencies = make_translation_unit_dependencies(cache.get());
+
+    struct diagram_state {
+        std::string name;
+        std::shared_ptr<clanguml::config::diagram> config;
+        const std::vector<std::string> &translation_units;
+        std::function<void()> progress;
+        std::string cache_key;
+        // Diagram model builders for each translation unit shard
+        std::vector<std::unique_ptr<diagram_model_builder>> builders;
+        bool failed{false};
+    };
+
+    std::vector<diagram_state> diagrams;
+
+    for (const auto &[name, diagram] : config.diagrams) {
+        // If there are any specific diagram names provided on the command
+        // line, and this diagram is not in that list - skip it
+        if (!diagram_names.empty() && !util::contains(diagram_names, name))
+            continue;
+
+        const auto &valid_translation_units = translation_units_map.at(name);
+
+        if (valid_translation_units.empty()) {
+            if (indicator) {
+                indicator->add_progress_bar(
+                    name, 0, diagram_type_to_color(diagram->type()));
+                indicator->fail(name);
+            }
+            else {
+                LOG_ERROR(
+                    "Diagram {} generation failed: no translation units "
+                    "found. Please make sure that your 'glob' patterns match "
+                    "at least 1 file in 'compile_commands.json'.",
+                    name);
+            }
+            continue;
+        }
+
+        if (indicator)
+            indicator->add_progress_bar(name,
+                db->count_matching_commands(valid_translation_units),
+                diagram_type_to_color(diagram->type()));
+
+        std::string cache_key;
+        if (cache) {
+            cache_key = diagram_skip_cache::make_key(*diagram, runtime_config);
+
+            if (cache->is_up_to_date(name, cache_key, *db,
+                    valid_translation_units,
+                    diagram_output_paths(name, runtime_config))) {
+                LOG_INFO("Diagram {} is up to date", name);
+
+                if (indicator)
+                    indicator->complete(name);
+                continue;
+            }
+        }
+
+        LOG_INFO("Generating diagram {}", name);
+
+        diagrams.push_back({name, diagram, valid_translation_units,
+            [&indicator, &name = name]() {
+                if (indicator)
+                    indicator->increment(name);
+            },
+            std::move(cache_key)});
+    }
+
+    const auto shard_count = std::max(runtime_config.tu_thread_count, 1U);
+
+    // Diagrams which cannot be built from merged partial models are visited
+    // with a single diagram model builder, in separate lanes
+    std::vector<size_t> sharded_diagrams;
+    std::vector<size_t> sequential_diagrams;
+    for (auto i = 0U; i < diagrams.size(); i++) {
+        if (shard_count > 1 &&
+            !supports_translation_unit_shards(diagrams[i].config->type()))
+            sequential_diagrams.push_back(i);
+        else
+            sharded_diagrams.push_back(i);
+    }
+
+    // Parse each translation unit once in the compilation database order,
+    // which keeps the order of translation units within each diagram the
+    // same as when diagrams are generated separately
+    auto database_order = [&db, &diagrams](
+                              const std::vector<size_t> &diagram_indexes) {
+        std::set<std::string> diagrams_translation_units;
+        for (const auto i : diagram_indexes)
+            diagrams_translation_units.insert(
+                diagrams[i].translation_units.begin(),
+                diagrams[i].translation_units.end());
+
+        std::vector<std::string> result;
+        for (auto &translation_unit : db->getAllFiles()) {
+            if (diagrams_translation_units.count(translation_unit) > 0)
+                result.emplace_back(std::move(translation_unit));
+        }
+        return result;
+    };
+
+    // Each lane visits its translation units sequentially, with the diagram
+    // model builders of all diagrams in the lane which include them
+    struct lane {
+        std::vector<std::string> translation_units;
+        // Diagram model builder of each diagram in this lane, if any
+        std::vector<diagram_model_builder *> builders;
+        // Whether visiting a translation unit failed for each diagram
+        std::vector<bool> failed;
+    };
+
+    std::vector<lane> lanes;
+    auto add_lane = [&lanes, &diagrams](std::vector<std::string> tus) {
+        lanes.push_back({std::move(tus),
+            std::vector<diagram_model_builder *>(diagrams.size(), nullptr),
+            std::vector<bool>(diagrams.size(), false)});
+    };
+
+    auto add_builder = [&diagrams, &lanes](size_t diagram, size_t lane) {
+        auto &d = diagrams[diagram];
+        d.builders.emplace_back(make_diagram_model_builder(
+            d.name, d.config, d.translation_units, d.progress));
+        lanes[lane].builders[diagram] = d.builders.back().get();
+    };
+
+    for (auto &shard : split_translation_units(
+             database_order(sharded_diagrams), shard_count)) {
+        add_lane(std::move(shard));
+
+        for (const auto i : sharded_diagrams)
+            add_builder(i, lanes.size() - 1);
+    }
+
+    if (!sequential_diagrams.empty()) {
+        // Distribute the diagrams between lanes, starting from the diagrams
+        // with the most translation units
+        std::sort(sequential_diagrams.begin(), sequential_diagrams.end(),
+            [&diagrams](size_t a, size_t b) {
+                return diagrams[a].translation_units.size() >
+                    diagrams[b].translation_units.size();
+            });
+
+        const auto first_lane = lanes.size();
+        const auto lane_count =
+            std::min<size_t>(shard_count, sequential_diagrams.size());
+
+        std::vector<std::vector<size_t>> lane_diagrams(lane_count);
+        std::vector<size_t> lane_sizes(lane_count, 0);
+
+        for (const auto i : sequential_diagrams) {
+            const auto l = static_cast<size_t>(std::distance(lane_sizes.begin(),
+                std::min_element(lane_sizes.begin(), lane_sizes.end())));
+
+            lane_diagrams[l].push_back(i);
+            lane_sizes[l] += diagrams[i].translation_units.size();
+        }
+
+        for (auto l = 0U; l < lane_count; l++) {
+            add_lane(database_order(lane_diagrams[l]));
+
+            for (const auto i : lane_diagrams[l])
+                add_builder(i, first_lane + l);
+        }
+    }
+
+    auto visit_lane = [&](lane &l,
+                          llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> fs) {
+        for (const auto &translation_unit : l.translation_units) {
+            std::vector<diagram_model_builder *> builders;
+            std::vector<size_t> diagram_indexes;
+            for (auto i = 0U; i < diagrams.size(); i++) {
+                auto *builder = l.builders[i];
+                if (builder != nullptr &&
+                    builder->has_translation_unit(translation_unit)) {
+                    builders.push_back(builder);
+                    diagram_indexes.push_back(i);
+                }
+            }
+
+            clang::tooling::ClangTool clang_tool(*db, {translation_unit},
+                std::make_shared<clang::PCHContainerOperations>(), fs);
+            shared_ast_action_factory action_factory{
+                std::move(builders), dependencies.get()};
+
+            if (clang_tool.run(&action_factory) != 0) {
+                for (auto i : diagram_indexes)
+                    l.failed[i] = true;
+            }
+        }
+    };
+
+    // Lanes visited in parallel need their own working directory, as
+    // ClangTool changes it for each compile command
+    const auto separate_working_directories = lanes.size() > 1;
+
+    std::vector<std::future<void>> lane_futs;
+    for (auto &l : lanes) {
+        lane_futs.emplace_back(generator_executor.add(
+            [&visit_lane, &l, separate_working_directories]() {
+                visit_lane(l,
+                    separate_working_directories
+                        ? llvm::vfs::createPhysicalFileSystem()
+                        : llvm::vfs::getRealFileSystem());
+            }));
+    }
+
+    generator_executor.wait(lane_futs);
+
+    // Merge partial diagram models in the order of the shards
+    for (auto i = 0U; i < diagrams.size(); i++) {
+        auto &d = diagrams[i];
+        for (const auto &l : lanes) {
+            if (l.failed[i])
+                d.failed = true;
+        }
+
+        for (auto shard = 1U; shard < d.builders.size(); shard++)
+            d.builders.front()->merge(*d.builders[shard]);
+
+        d.builders.resize(1);
+    }
+
+    for (auto &d : diagrams) {
+        auto generator = [&d, &indicator, &cache, &renderer, &dependencies,
+                             &db, runtime_config]() {
+            try {
+                if (d.failed) {
+                    throw std::runtime_error(
+                        "Diagram " + d.name + " generation failed");
+                }
+
+                d.builders.front()->complete();
+
+                generate_diagram_outputs(
+                    d.name, d.config, *d.builders.front(), runtime_config);
+
+                if (cache)
+                    cache->update(d.name, d.cache_key, *db,
+                        d.translation_units, *dependencies);
+
+                render_diagram_outputs(renderer.get(), d.name, d.config,
+                    runtime_config, cache.get(), indicator.get());
+            }
+            catch (const std::exception &e) {
+                if (indicator)
+                    indicator->fail(d.name);
+
+                LOG_ERROR("ERROR: Failed to generate diagram {}: {}", d.name,
+                    e.what());
+            }
+        };
+
+        futs.emplace_back(generator_executor.add(std::move(generator)));
+    }
+
+    for (auto &fut : futs) {
+        fut.get();
+    }
+
+    if (renderer)
+        renderer->wait();
+
+    if (runtime_config.progress) {
+        indicator->stop();
+        std::cout << termcolor::white << "Done\n";
+        std::cout << termcolor::reset;
     }
 }
 
@@ -213,6 +843,12 @@ void generate_diagrams(const std::vector<std::string> &diagram_names,
     const std::map<std::string, std::vector<std::string>>
         &translation_units_map)
 {
+    if (runtime_config.shared_ast) {
+        generate_diagrams_shared_ast(diagram_names, config, db, runtime_config,
+            translation_units_map);
+        return;
+    }
+
     util::thread_pool_executor generator_executor{runtime_config.thread_count};
     std::vector<std::future<void>> futs;
 
@@ -224,6 +860,10 @@ void generate_diagrams(const std::vector<std::string> &diagram_names,
         indicator = std::make_unique<progress_indicator>();
     }
 
+    const auto cache = make_diagram_skip_cache(runtime_config);
+    const auto renderer = make_diagram_renderer(runtime_config);
+    const auto dependencies = make_translation_unit_dependencies(cache.get());
+
     for (const auto &[name, diagram] : config.diagrams) {
         // If there are any specific diagram names provided on the command
         // line, and this diagram is not in that list - skip it
@@ -252,7 +892,9 @@ void generate_diagrams(const std::vector<std::string> &diagram_names,
             db->count_matching_commands(valid_translation_units);
 
         auto generator = [&name = name, &diagram = diagram, &indicator,
-                             db = std::ref(*db), matching_commands_count,
+                             &cache, &renderer, &dependencies,
+                             db = std::ref(*db),
+                             matching_commands_count,
                              translation_units = valid_translation_units,
                              runtime_config]() mutable {
             try {
@@ -260,14 +902,36 @@ void generate_diagrams(const std::vector<std::string> &diagram_names,
                     indicator->add_progress_bar(name, matching_commands_count,
                         diagram_type_to_color(diagram->type()));
 
-                generate_diagram(name, diagram, db, translation_units,
-                    runtime_config, [&indicator, &name]() {
+                std::string cache_key;
+                if (cache) {
+                    cache_key =
+                        diagram_skip_cache::make_key(*diagram, runtime_config);
+
+                    if (cache->is_up_to_date(name, cache_key, db,
+                            translation_units,
+                            diagram_output_paths(name, runtime_config))) {
+                        LOG_INFO("Diagram {} is up to date", name);
+
+                        if (indicator)
+                            indicator->complete(name);
+                        return;
+                    }
+                }
+
+                generate_diagram(
+                    name, diagram, db, translation_units, runtime_config,
+                    [&indicator, &name]() {
                         if (indicator)
                             indicator->increment(name);
-                    });
+                    },
+                    dependencies.get());
 
-                if (indicator)
-                    indicator->complete(name);
+                if (cache)
+                    cache->update(
+                        name, cache_key, db, translation_units, *dependencies);
+
+                render_diagram_outputs(renderer.get(), name, diagram,
+                    runtime_config, cache.get(), indicator.get());
             }
             catch (const std::exception &e) {
                 if (indicator)
@@ -285,6 +949,9 @@ void generate_diagrams(const std::vector<std::string> &diagram_names,
         fut.get();
     }
 
+    if (renderer)
+        renderer->wait();
+
     if (runtime_config.progress) {
         indicator->stop();
         std::cout << termcolor::white << "Done\n";
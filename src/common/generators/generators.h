@@ -22,6 +22,8 @@
 #include "class_diagram/generators/plantuml/class_diagram_generator.h"
 #include "cli/cli_handler.h"
 #include "common/compilation_database.h"
+#include "common/generators/diagram_renderer.h"
+#include "common/generators/diagram_skip_cache.h"
 #include "common/model/diagram_filter.h"
 #include "config/config.h"
 #include "include_diagram/generators/json/include_diagram_generator.h"
@@ -38,7 +40,10 @@
 #include "version.h"
 
 #include <clang/Frontend/CompilerInstance.h>
+#include <clang/Frontend/FrontendActions.h>
+#include <clang/Frontend/MultiplexConsumer.h>
 #include <clang/Tooling/Tooling.h>
+#include <llvm/Support/VirtualFileSystem.h>
 
 #include <cstring>
 #include <filesystem>
@@ -46,7 +51,9 @@
 #include <future>
 #include <iostream>
 #include <map>
+#include <optional>
 #include <string>
+#include <unordered_set>
 #include <util/thread_pool_executor.h>
 #include <vector>
 
@@ -74,6 +81,32 @@ template <> struct diagram_model_t<clanguml::config::include_diagram> {
 };
 /** @} */
 
+/**
+ * @brief Check whether a diagram can be built from merged partial models
+ *
+ * Class diagram visitors look up elements found in previously visited
+ * translation units, e.g. when searching for the best matching template
+ * specialization of a template instantiation, or when adding dependencies
+ * on template arguments. A partial model built from a shard of translation
+ * units does not contain elements from the preceding shards, so class
+ * diagrams are always built from translation units visited sequentially.
+ *
+ * @tparam DiagramModel Type of diagram_model
+ */
+template <typename DiagramModel>
+inline constexpr bool supports_translation_unit_shards_v =
+    !std::is_same_v<DiagramModel, clanguml::class_diagram::model::diagram>;
+
+/**
+ * @brief Check whether a diagram can be built from merged partial models
+ *
+ * @see supports_translation_unit_shards_v
+ *
+ * @param diagram_type Diagram type
+ * @return True, if translation units of the diagram can be split into shards
+ */
+bool supports_translation_unit_shards(model::diagram_t diagram_type);
+
 /** @defgroup diagram_visitor_t Diagram model selector
  *
  * Template traits for selecting diagram visitor type based on diagram config
@@ -256,10 +289,12 @@ template <typename DiagramModel, typename DiagramConfig,
 class diagram_fronted_action : public clang::ASTFrontendAction {
 public:
     explicit diagram_fronted_action(DiagramModel &diagram,
-        const DiagramConfig &config, std::function<void()> progress)
+        const DiagramConfig &config, std::function<void()> progress,
+        translation_unit_dependencies *dependencies = nullptr)
         : diagram_{diagram}
         , config_{config}
         , progress_{std::move(progress)}
+        , dependencies_{dependencies}
     {
     }
 
@@ -270,10 +305,7 @@ public:
             diagram_ast_consumer<DiagramModel, DiagramConfig, DiagramVisitor>>(
             CI, diagram_, config_);
 
-        if constexpr (!std::is_same_v<DiagramModel,
-                          clanguml::include_diagram::model::diagram>) {
-            ast_consumer->visitor().set_tu_path(getCurrentFile().str());
-        }
+        ast_consumer->visitor().set_tu_path(getCurrentFile().str());
 
         return ast_consumer;
     }
@@ -288,16 +320,61 @@ protected:
         if (progress_)
             progress_();
 
-        if constexpr (std::is_same_v<DiagramModel,
-                          clanguml::include_diagram::model::diagram>) {
-            auto find_includes_callback =
-                std::make_unique<typename DiagramVisitor::include_visitor>(
-                    ci.getSourceManager(), diagram_, config_);
+        if (dependencies_ != nullptr)
+            dependencies_->attach(ci, getCurrentFile().str());
 
-            clang::Preprocessor &pp = ci.getPreprocessor();
+        return true;
+    }
 
-            pp.addPPCallbacks(std::move(find_includes_callback));
-        }
+private:
+    DiagramModel &diagram_;
+    const DiagramConfig &config_;
+    std::function<void()> progress_;
+    translation_unit_dependencies *dependencies_;
+};
+
+/**
+ * @brief Specialization of
+ * [clang::PreprocessOnlyAction](https://clang.llvm.org/doxygen/classclang_1_1PreprocessOnlyAction.html)
+ *
+ * Include diagrams are built only from preprocessor callbacks, so their
+ * translation units are only preprocessed, without building and analyzing
+ * the AST.
+ *
+ * @tparam DiagramModel Type of diagram_model
+ * @tparam DiagramConfig Type of diagram_config
+ * @tparam TranslationUnitVisitor Type of translation_unit_visitor
+ */
+template <typename DiagramModel, typename DiagramConfig,
+    typename DiagramVisitor>
+class diagram_preprocessor_fronted_action : public clang::PreprocessOnlyAction {
+public:
+    explicit diagram_preprocessor_fronted_action(DiagramModel &diagram,
+        const DiagramConfig &config, std::function<void()> progress,
+        translation_unit_dependencies *dependencies = nullptr)
+        : diagram_{diagram}
+        , config_{config}
+        , progress_{std::move(progress)}
+        , dependencies_{dependencies}
+    {
+    }
+
+protected:
+    bool BeginSourceFileAction(clang::CompilerInstance &ci) override
+    {
+        LOG_DBG("Preprocessing source file: {}", getCurrentFile().str());
+
+        // Update progress indicators, if enabled, on each translation
+        // unit
+        if (progress_)
+            progress_();
+
+        if (dependencies_ != nullptr)
+            dependencies_->attach(ci, getCurrentFile().str());
+
+        ci.getPreprocessor().addPPCallbacks(
+            std::make_unique<typename DiagramVisitor::include_visitor>(
+                ci.getSourceManager(), diagram_, config_));
 
         return true;
     }
@@ -306,6 +383,7 @@ private:
     DiagramModel &diagram_;
     const DiagramConfig &config_;
     std::function<void()> progress_;
+    translation_unit_dependencies *dependencies_;
 };
 
 /**
@@ -313,7 +391,8 @@ private:
  * [clang::ASTFrontendAction](https://clang.llvm.org/doxygen/classclang_1_1tooling_1_1FrontendActionFactory.html)
  *
  * This class overrides the create() method in order to create an instance
- * of diagram_frontend_action of appropriate type.
+ * of diagram_frontend_action of appropriate type, or for include diagrams
+ * an instance of diagram_preprocessor_fronted_action.
  *
  * @tparam DiagramModel Type of diagram_model
  * @tparam DiagramConfig Type of diagram_config
@@ -325,25 +404,334 @@ class diagram_action_visitor_factory
     : public clang::tooling::FrontendActionFactory {
 public:
     explicit diagram_action_visitor_factory(DiagramModel &diagram,
-        const DiagramConfig &config, std::function<void()> progress)
+        const DiagramConfig &config, std::function<void()> progress,
+        translation_unit_dependencies *dependencies = nullptr)
         : diagram_{diagram}
         , config_{config}
         , progress_{std::move(progress)}
+        , dependencies_{dependencies}
     {
     }
 
     std::unique_ptr<clang::FrontendAction> create() override
     {
-        return std::make_unique<diagram_fronted_action<DiagramModel,
-            DiagramConfig, DiagramVisitor>>(diagram_, config_, progress_);
+        if constexpr (std::is_same_v<DiagramModel,
+                          clanguml::include_diagram::model::diagram>) {
+            return std::make_unique<diagram_preprocessor_fronted_action<
+                DiagramModel, DiagramConfig, DiagramVisitor>>(
+                diagram_, config_, progress_, dependencies_);
+        }
+        else {
+            return std::make_unique<diagram_fronted_action<DiagramModel,
+                DiagramConfig, DiagramVisitor>>(
+                diagram_, config_, progress_, dependencies_);
+        }
     }
 
 private:
     DiagramModel &diagram_;
     const DiagramConfig &config_;
     std::function<void()> progress_;
+    translation_unit_dependencies *dependencies_;
+};
+
+/**
+ * @brief Diagram model builder interface for the shared AST pipeline
+ *
+ * In shared AST mode each translation unit is parsed only once, and the
+ * resulting AST is visited by the translation unit visitors of all diagrams
+ * which include this translation unit. This interface hides the specific
+ * diagram model, config and visitor types from the shared frontend action.
+ */
+class diagram_model_builder {
+public:
+    virtual ~diagram_model_builder() = default;
+
+    /**
+     * @brief Name of the diagram built by this builder
+     *
+     * @return Diagram name
+     */
+    virtual const std::string &name() const = 0;
+
+    /**
+     * @brief Check whether the diagram should visit a translation unit
+     *
+     * @param translation_unit Path to the translation unit
+     * @return True, if the translation unit belongs to this diagram
+     */
+    virtual bool has_translation_unit(
+        const std::string &translation_unit) const = 0;
+
+    /**
+     * @brief Prepare the diagram for visiting a new translation unit
+     *
+     * @param ci Reference to the compiler instance of the translation unit
+     */
+    virtual void begin_source_file(clang::CompilerInstance &ci) = 0;
+
+    /**
+     * @brief Check whether the diagram is built from the translation unit AST
+     *
+     * Diagrams which do not require the AST (i.e. include diagrams) are
+     * built only from preprocessor callbacks registered in
+     * begin_source_file().
+     *
+     * @return True, if the translation units must be parsed
+     */
+    virtual bool requires_ast() const = 0;
+
+    /**
+     * @brief Create AST consumer, which will populate the diagram model
+     *
+     * This is only called for diagrams which require the AST.
+     *
+     * @param ci Reference to the compiler instance of the translation unit
+     * @param file Path to the translation unit
+     * @return AST consumer for this diagram
+     */
+    virtual std::unique_ptr<clang::ASTConsumer> create_ast_consumer(
+        clang::CompilerInstance &ci, const std::string &file) = 0;
+
+    /**
+     * @brief Merge partial diagram model built by another builder
+     *
+     * @param other Builder of the same diagram for subsequent translation
+     *              units
+     */
+    virtual void merge(diagram_model_builder &other) = 0;
+
+    /**
+     * @brief Complete and finalize the diagram model
+     *
+     * This must be called after all translation units have been visited.
+     */
+    virtual void complete() = 0;
+};
+
+/**
+ * @brief Diagram model builder for a specific diagram type
+ *
+ * @tparam DiagramConfig Type of diagram_config
+ */
+template <typename DiagramConfig>
+class diagram_model_builder_t : public diagram_model_builder {
+public:
+    using diagram_model = typename diagram_model_t<DiagramConfig>::type;
+    using diagram_visitor = typename diagram_visitor_t<DiagramConfig>::type;
+
+    diagram_model_builder_t(const std::string &name,
+        const DiagramConfig &config,
+        const std::vector<std::string> &translation_units,
+        std::function<void()> progress)
+        : name_{name}
+        , config_{config}
+        , translation_units_{translation_units.begin(),
+              translation_units.end()}
+        , progress_{std::move(progress)}
+        , diagram_{std::make_unique<diagram_model>()}
+    {
+        diagram_->set_name(name);
+        diagram_->set_filter(
+            std::make_unique<model::diagram_filter>(*diagram_, config));
+    }
+
+    const std::string &name() const override { return name_; }
+
+    bool has_translation_unit(
+        const std::string &translation_unit) const override
+    {
+        return translation_units_.count(translation_unit) > 0;
+    }
+
+    void begin_source_file(clang::CompilerInstance &ci) override
+    {
+        if (progress_)
+            progress_();
+
+        if constexpr (std::is_same_v<diagram_model,
+                          clanguml::include_diagram::model::diagram>) {
+            ci.getPreprocessor().addPPCallbacks(
+                std::make_unique<typename diagram_visitor::include_visitor>(
+                    ci.getSourceManager(), *diagram_, config_));
+        }
+    }
+
+    bool requires_ast() const override
+    {
+        return !std::is_same_v<diagram_model,
+            clanguml::include_diagram::model::diagram>;
+    }
+
+    std::unique_ptr<clang::ASTConsumer> create_ast_consumer(
+        clang::CompilerInstance &ci, const std::string &file) override
+    {
+        if constexpr (std::is_same_v<diagram_model,
+                          clanguml::include_diagram::model::diagram>) {
+            return {};
+        }
+        else {
+            auto ast_consumer = std::make_unique<
+                diagram_ast_consumer<diagram_model, DiagramConfig,
+                    diagram_visitor>>(ci, *diagram_, config_);
+
+            ast_consumer->visitor().set_tu_path(file);
+
+            return ast_consumer;
+        }
+    }
+
+    void merge(diagram_model_builder &other) override
+    {
+        diagram_->merge(std::move(
+            *dynamic_cast<diagram_model_builder_t<DiagramConfig> &>(other)
+                 .model()));
+    }
+
+    void complete() override
+    {
+        diagram_->set_complete(true);
+
+        diagram_visitor::finalize_diagram(*diagram_, config_);
+
+        diagram_->finalize();
+    }
+
+    /**
+     * @brief Get the diagram model
+     *
+     * @return Reference to the diagram model
+     */
+    std::unique_ptr<diagram_model> &model() { return diagram_; }
+
+private:
+    std::string name_;
+    const DiagramConfig &config_;
+    std::unordered_set<std::string> translation_units_;
+    std::function<void()> progress_;
+    std::unique_ptr<diagram_model> diagram_;
+};
+
+/**
+ * @brief Frontend action running visitors of multiple diagrams on the same
+ *        translation unit AST
+ *
+ * The AST consumers of all diagram builders are combined using
+ * [clang::MultiplexConsumer](https://clang.llvm.org/doxygen/classclang_1_1MultiplexConsumer.html),
+ * so that the translation unit is parsed and analyzed only once.
+ */
+class shared_ast_fronted_action : public clang::ASTFrontendAction {
+public:
+    explicit shared_ast_fronted_action(
+        std::vector<diagram_model_builder *> builders,
+        translation_unit_dependencies *dependencies = nullptr);
+
+    std::unique_ptr<clang::ASTConsumer> CreateASTConsumer(
+        clang::CompilerInstance &CI, clang::StringRef file) override;
+
+protected:
+    bool BeginSourceFileAction(clang::CompilerInstance &ci) override;
+
+private:
+    std::vector<diagram_model_builder *> builders_;
+    translation_unit_dependencies *dependencies_;
+};
+
+/**
+ * @brief Frontend action running preprocessor callbacks of multiple diagrams
+ *        on the same translation unit
+ *
+ * This action is used instead of shared_ast_fronted_action when none of the
+ * diagrams visiting the translation unit requires the AST, in which case the
+ * translation unit is only preprocessed.
+ */
+class shared_preprocessor_fronted_action : public clang::PreprocessOnlyAction {
+public:
+    explicit shared_preprocessor_fronted_action(
+        std::vector<diagram_model_builder *> builders,
+        translation_unit_dependencies *dependencies = nullptr);
+
+protected:
+    bool BeginSourceFileAction(clang::CompilerInstance &ci) override;
+
+private:
+    std::vector<diagram_model_builder *> builders_;
+    translation_unit_dependencies *dependencies_;
 };
 
+/**
+ * @brief Frontend action factory for the shared AST pipeline
+ */
+class shared_ast_action_factory : public clang::tooling::FrontendActionFactory {
+public:
+    explicit shared_ast_action_factory(
+        std::vector<diagram_model_builder *> builders,
+        translation_unit_dependencies *dependencies = nullptr);
+
+    std::unique_ptr<clang::FrontendAction> create() override;
+
+private:
+    std::vector<diagram_model_builder *> builders_;
+    translation_unit_dependencies *dependencies_;
+};
+
+/**
+ * @brief Split translation units into consecutive shards
+ *
+ * The order of translation units is preserved, i.e. concatenating the
+ * resulting shards gives the original list.
+ *
+ * @param translation_units List of translation units
+ * @param shard_count Maximum number of shards
+ * @return List of translation unit shards
+ */
+std::vector<std::vector<std::string>> split_translation_units(
+    const std::vector<std::string> &translation_units,
+    unsigned int shard_count);
+
+namespace detail {
+/**
+ * @brief Visit translation units and build a partial diagram model
+ *
+ * @tparam DiagramModel Type of diagram_model
+ * @tparam DiagramConfig Type of diagram_config
+ * @tparam TranslationUnitVisitor Type of translation_unit_visitor
+ * @param fs File system used by the Clang tool, each thread running
+ *        a Clang tool must use a separate instance
+ * @param dependencies If not null, collects files read by each translation
+ *        unit
+ */
+template <typename DiagramModel, typename DiagramConfig,
+    typename DiagramVisitor>
+std::unique_ptr<DiagramModel> visit_translation_units(
+    const common::compilation_database &db, const std::string &name,
+    DiagramConfig &config, const std::vector<std::string> &translation_units,
+    std::function<void()> progress,
+    llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> fs,
+    translation_unit_dependencies *dependencies)
+{
+    auto diagram = std::make_unique<DiagramModel>();
+    diagram->set_name(name);
+    diagram->set_filter(
+        std::make_unique<model::diagram_filter>(*diagram, config));
+
+    clang::tooling::ClangTool clang_tool(db, translation_units,
+        std::make_shared<clang::PCHContainerOperations>(), std::move(fs));
+    auto action_factory =
+        std::make_unique<diagram_action_visitor_factory<DiagramModel,
+            DiagramConfig, DiagramVisitor>>(
+            *diagram, config, std::move(progress), dependencies);
+
+    auto res = clang_tool.run(action_factory.get());
+
+    if (res != 0) {
+        throw std::runtime_error("Diagram " + name + " generation failed");
+    }
+
+    return diagram;
+}
+} // namespace detail
+
 /**
  * @brief Specialization of
  * [clang::ASTFrontendAction](https://clang.llvm.org/doxygen/classclang_1_1tooling_1_1FrontendActionFactory.html)
@@ -351,6 +739,13 @@ private:
  * This is the entry point function to initiate AST frontend action for a
  * specific diagram.
  *
+ * If `translation_unit_threads` is larger than 1, and the diagram type
+ * supports it (see supports_translation_unit_shards_v), the translation units
+ * are split into consecutive shards, which are visited in parallel into
+ * separate partial diagram models. The partial models are then merged in
+ * the order of the shards. If called from a task running on a
+ * util::thread_pool_executor, the shards are added to that pool.
+ *
  * @embed{diagram_generate_generic_sequence.svg}
  *
  * @tparam DiagramModel Type of diagram_model
@@ -362,32 +757,63 @@ template <typename DiagramModel, typename DiagramConfig,
 std::unique_ptr<DiagramModel> generate(const common::compilation_database &db,
     const std::string &name, DiagramConfig &config,
     const std::vector<std::string> &translation_units, bool /*verbose*/ = false,
-    std::function<void()> progress = {})
+    std::function<void()> progress = {},
+    unsigned int translation_unit_threads = 1,
+    translation_unit_dependencies *dependencies = nullptr)
 {
     LOG_INFO("Generating diagram {}", name);
 
-    auto diagram = std::make_unique<DiagramModel>();
-    diagram->set_name(name);
-    diagram->set_filter(
-        std::make_unique<model::diagram_filter>(*diagram, config));
-
     LOG_DBG("Found translation units for diagram {}: {}", name,
         fmt::join(translation_units, ", "));
 
-    clang::tooling::ClangTool clang_tool(db, translation_units);
-    auto action_factory =
-        std::make_unique<diagram_action_visitor_factory<DiagramModel,
-            DiagramConfig, DiagramVisitor>>(
-            *diagram, config, std::move(progress));
+    std::unique_ptr<DiagramModel> diagram;
+
+    if (supports_translation_unit_shards_v<DiagramModel> &&
+        translation_unit_threads > 1 && translation_units.size() > 1) {
+        const auto shards = split_translation_units(
+            translation_units, translation_unit_threads);
+
+        std::vector<std::unique_ptr<DiagramModel>> partial_diagrams(
+            shards.size());
+        std::vector<std::future<void>> futs;
+
+        // When called from a diagram generation task, visit the shards on
+        // the same pool, otherwise create a pool for the shards
+        std::optional<util::thread_pool_executor> local_executor;
+        auto *executor = util::thread_pool_executor::current();
+        if (executor == nullptr)
+            executor = &local_executor.emplace(translation_unit_threads);
+
+        for (auto i = 0U; i < shards.size(); i++) {
+            futs.emplace_back(executor->add([&, i]() {
+                partial_diagrams[i] = detail::visit_translation_units<
+                    DiagramModel, DiagramConfig, DiagramVisitor>(db, name,
+                    config, shards[i], progress,
+                    llvm::vfs::createPhysicalFileSystem(), dependencies);
+            }));
+        }
 
-    auto res = clang_tool.run(action_factory.get());
+        executor->wait(futs);
 
-    if (res != 0) {
-        throw std::runtime_error("Diagram " + name + " generation failed");
+        diagram = std::move(partial_diagrams.front());
+
+        for (auto i = 1U; i < partial_diagrams.size(); i++) {
+            diagram->merge(std::move(*partial_diagrams[i]));
+        }
+    }
+    else {
+        diagram = detail::visit_translation_units<DiagramModel, DiagramConfig,
+            DiagramVisitor>(db, name, config, translation_units,
+            std::move(progress), llvm::vfs::getRealFileSystem(),
+            dependencies);
     }
 
     diagram->set_complete(true);
 
+    // Post process the diagram model once all translation units have been
+    // visited and merged
+    DiagramVisitor::finalize_diagram(*diagram, config);
+
     diagram->finalize();
 
     return diagram;
@@ -403,13 +829,26 @@ std::unique_ptr<DiagramModel> generate(const common::compilation_database &db,
  * @param generators List of generator types to be used for the diagram
  * @param verbose Log level
  * @param progress Function to report translation unit progress
+ * @param dependencies If not null, collects files read by each translation
+ *        unit
  */
 void generate_diagram(const std::string &name,
     std::shared_ptr<clanguml::config::diagram> diagram,
     const common::compilation_database &db,
     const std::vector<std::string> &translation_units,
     const cli::runtime_config &runtime_config,
-    std::function<void()> &&progress);
+    std::function<void()> &&progress,
+    translation_unit_dependencies *dependencies = nullptr);
+
+/**
+ * @brief Get paths of output files generated for a diagram
+ *
+ * @param name Name of the diagram
+ * @param runtime_config Runtime options from the command line
+ * @return List of diagram output file paths
+ */
+std::vector<std::filesystem::path> diagram_output_paths(
+    const std::string &name, const cli::runtime_config &runtime_config);
 
 /**
  * @brief Generate diagrams
@@ -431,6 +870,27 @@ void generate_diagrams(const std::vector<std::string> &diagram_names,
     const std::map<std::string, std::vector<std::string>>
         &translation_units_map);
 
+/**
+ * @brief Generate diagrams parsing each translation unit only once
+ *
+ * Instead of running a separate Clang tool for each diagram, this function
+ * parses each translation unit once and visits its AST with translation
+ * unit visitors of all diagrams which include it. Once all translation units
+ * are processed, the diagrams are generated in parallel.
+ *
+ * @param diagram_names List of diagram names to generate
+ * @param config Reference to config instance
+ * @param db Reference to compilation database
+ * @param runtime_config Runtime options from the command line
+ * @param translation_units_map Map of translation units for each file
+ */
+void generate_diagrams_shared_ast(const std::vector<std::string> &diagram_names,
+    clanguml::config::config &config,
+    const common::compilation_database_ptr &db,
+    const cli::runtime_config &runtime_config,
+    const std::map<std::string, std::vector<std::string>>
+        &translation_units_map);
+
 /**
  * @brief Return indicators progress bar color for diagram type
  *
@@ -18,6 +18,7 @@
 #pragma once
 
 #include "common/generators/generator.h"
+#include "common/generators/json/writer.h"
 #include "common/model/diagram_filter.h"
 #include "config/config.h"
 #include "util/error.h"
@@ -90,6 +91,22 @@ public:
      */
     virtual void generate_diagram(nlohmann::json &parent) const = 0;
 
+    /**
+     * @brief Generate members of the root JSON object, which are written
+     *        directly to the output stream
+     *
+     * Subclasses can override this method in order to write large parts of
+     * the diagram (e.g. arrays of diagram elements) item by item, instead of
+     * adding them to the root JSON object in generate_diagram(). The
+     * streamed members are written after generate_diagram() is called.
+     *
+     * @param members Streamed members of the root JSON object
+     */
+    virtual void generate_streamed_members(
+        streamed_members_t & /*members*/) const
+    {
+    }
+
     /**
      * @brief Generate metadata element with diagram metadata
      *
@@ -128,7 +145,16 @@ void generator<C, D>::generate(std::ostream &ostr) const
 
     generate_metadata(j);
 
-    ostr << j;
+    streamed_members_t streamed;
+    generate_streamed_members(streamed);
+
+    if (streamed.empty()) {
+        ostr << j;
+        return;
+    }
+
+    writer w{ostr};
+    write_object(w, j, streamed);
 }
 
 template <typename C, typename D>
@@ -0,0 +1,146 @@
+/**
+ * @file src/common/generators/json/writer.cc
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "writer.h"
+
+#include <cassert>
+
+namespace clanguml::common::generators::json {
+
+writer::writer(std::ostream &ostr)
+    : ostr_{ostr}
+{
+}
+
+void writer::begin_object()
+{
+    before_value();
+    ostr_ << '{';
+    scopes_.push_back({true, true, {}});
+}
+
+void writer::end_object()
+{
+    assert(!scopes_.empty() && scopes_.back().is_object && !after_key_);
+
+    scopes_.pop_back();
+    ostr_ << '}';
+}
+
+void writer::begin_array()
+{
+    before_value();
+    ostr_ << '[';
+    scopes_.push_back({false, true, {}});
+}
+
+void writer::end_array()
+{
+    assert(!scopes_.empty() && !scopes_.back().is_object);
+
+    scopes_.pop_back();
+    ostr_ << ']';
+}
+
+void writer::key(std::string_view k)
+{
+    assert(!scopes_.empty() && scopes_.back().is_object && !after_key_);
+
+    auto &s = scopes_.back();
+
+    // nlohmann::json stores object members sorted by their keys
+    assert(s.empty || s.last_key < k);
+
+    if (!s.empty)
+        ostr_ << ',';
+
+    s.empty = false;
+    s.last_key = k;
+
+    ostr_ << nlohmann::json(s.last_key).dump() << ':';
+
+    after_key_ = true;
+}
+
+void writer::value(const nlohmann::json &v)
+{
+    before_value();
+    ostr_ << v.dump();
+}
+
+void writer::raw(std::string_view v)
+{
+    before_value();
+    ostr_ << v;
+}
+
+void writer::member(std::string_view k, const nlohmann::json &v)
+{
+    key(k);
+    value(v);
+}
+
+void writer::before_value()
+{
+    if (after_key_) {
+        after_key_ = false;
+        return;
+    }
+
+    if (scopes_.empty())
+        return;
+
+    auto &s = scopes_.back();
+
+    assert(!s.is_object);
+
+    if (!s.empty)
+        ostr_ << ',';
+
+    s.empty = false;
+}
+
+void write_object(writer &w, const nlohmann::json &object,
+    const streamed_members_t &streamed)
+{
+    assert(object.is_object());
+
+    w.begin_object();
+
+    auto it = object.cbegin();
+    auto streamed_it = streamed.cbegin();
+
+    while (it != object.cend() || streamed_it != streamed.cend()) {
+        if (streamed_it == streamed.cend() ||
+            (it != object.cend() && it.key() < streamed_it->first)) {
+            w.member(it.key(), it.value());
+            ++it;
+        }
+        else {
+            assert(!object.contains(streamed_it->first));
+
+            w.key(streamed_it->first);
+            streamed_it->second(w);
+            ++streamed_it;
+        }
+    }
+
+    w.end_object();
+}
+
+} // namespace clanguml::common::generators::json
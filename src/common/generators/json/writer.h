@@ -0,0 +1,133 @@
+/**
+ * @file src/common/generators/json/writer.h
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <functional>
+#include <map>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace clanguml::common::generators::json {
+
+/**
+ * @brief Streaming JSON writer
+ *
+ * Writes JSON documents directly to an output stream, so that large arrays
+ * (e.g. diagram elements) can be written one item at a time, without
+ * building the entire document in memory first.
+ *
+ * The output is identical to the compact serialization of an equivalent
+ * `nlohmann::json` document, as long as the keys of each object are written
+ * in sorted order, which is the order in which `nlohmann::json` stores them.
+ */
+class writer {
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param ostr Output stream
+     */
+    explicit writer(std::ostream &ostr);
+
+    /**
+     * @brief Start JSON object
+     */
+    void begin_object();
+
+    /**
+     * @brief End current JSON object
+     */
+    void end_object();
+
+    /**
+     * @brief Start JSON array
+     */
+    void begin_array();
+
+    /**
+     * @brief End current JSON array
+     */
+    void end_array();
+
+    /**
+     * @brief Write key of the next member of the current object
+     *
+     * @param k Member key, must be greater than the previous key
+     */
+    void key(std::string_view k);
+
+    /**
+     * @brief Write value, i.e. array item or value of the last written key
+     *
+     * @param v JSON value
+     */
+    void value(const nlohmann::json &v);
+
+    /**
+     * @brief Write serialized JSON value, e.g. buffered array items
+     *
+     * @param v Compact serialization of a JSON value
+     */
+    void raw(std::string_view v);
+
+    /**
+     * @brief Write object member
+     *
+     * @param k Member key, must be greater than the previous key
+     * @param v JSON value
+     */
+    void member(std::string_view k, const nlohmann::json &v);
+
+private:
+    struct scope {
+        bool is_object;
+        bool empty{true};
+        std::string last_key;
+    };
+
+    void before_value();
+
+    std::ostream &ostr_;
+    std::vector<scope> scopes_;
+    bool after_key_{false};
+};
+
+/**
+ * @brief Members of a JSON object written directly to the output stream
+ *
+ * Maps object keys to functions writing the values of the members.
+ */
+using streamed_members_t =
+    std::map<std::string, std::function<void(writer &)>>;
+
+/**
+ * @brief Write JSON object with members from a JSON object and streamed
+ *        members, in sorted order of their keys
+ *
+ * @param w JSON writer
+ * @param object JSON object with the regular members
+ * @param streamed Members, whose values are written by functions
+ */
+void write_object(writer &w, const nlohmann::json &object,
+    const streamed_members_t &streamed);
+
+} // namespace clanguml::common::generators::json
@@ -31,6 +31,8 @@
 #include <glob/glob.hpp>
 #include <inja/inja.hpp>
 
+#include <unordered_map>
+
 namespace clanguml::common::generators::mermaid {
 
 using clanguml::common::model::access_t;
@@ -182,9 +184,36 @@ protected:
 
     inja::Environment &env() const;
 
-    template <typename E> inja::json element_context(const E &e) const;
+    /**
+     * @brief Get parsed Jinja template
+     *
+     * Templates are parsed only once per generator and cached by their
+     * source text.
+     *
+     * @param tmpl Jinja template source
+     * @return Parsed template
+     */
+    const inja::Template &parse_template(const std::string &tmpl) const;
+
+    /**
+     * @brief Render Jinja template in the context of a diagram element
+     *
+     * Instead of copying the diagram context for each element, the element
+     * context is temporarily added to the shared diagram context under the
+     * `element` key.
+     *
+     * @tparam E Diagram element type
+     * @param tmpl Jinja template source
+     * @param e Diagram element
+     * @return Rendered template
+     */
+    template <typename E>
+    std::string render_element_template(
+        const std::string &tmpl, const E &e) const;
 
 private:
+    template <typename E> inja::json element_only_context(const E &e) const;
+
     void init_context();
 
     void init_env();
@@ -193,6 +222,7 @@ protected:
     mutable std::set<std::string> m_generated_aliases;
     mutable inja::json m_context;
     mutable inja::Environment m_env;
+    mutable std::unordered_map<std::string, inja::Template> m_templates;
 };
 
 template <typename C, typename D>
@@ -209,43 +239,73 @@ inja::Environment &generator<C, D>::env() const
 
 template <typename C, typename D>
 template <typename E>
-inja::json generator<C, D>::element_context(const E &e) const
+inja::json generator<C, D>::element_only_context(const E &e) const
 {
-    auto ctx = context();
-
-    ctx["element"] = e.context();
+    inja::json ctx = e.context();
 
     if (!e.file().empty()) {
         std::filesystem::path file{e.file()};
         std::string git_relative_path = file.string();
         if (!e.file_relative().empty()) {
 #if _MSC_VER
-            if (file.is_absolute() && ctx.contains("git"))
+            if (file.is_absolute() && context().contains("git")) {
 #else
-            if (file.is_absolute() && ctx.template contains("git"))
+            if (file.is_absolute() && context().template contains("git")) {
 #endif
+                const auto &toplevel = context()["git"]["toplevel"];
                 git_relative_path =
-                    std::filesystem::relative(file, ctx["git"]["toplevel"])
-                        .string();
+                    std::filesystem::relative(file, toplevel).string();
+            }
         }
         else {
             git_relative_path = "";
         }
 
-        ctx["element"]["source"]["path"] = util::path_to_url(git_relative_path);
-        ctx["element"]["source"]["full_path"] = file.string();
-        ctx["element"]["source"]["name"] = file.filename().string();
-        ctx["element"]["source"]["line"] = e.line();
+        ctx["source"]["path"] = util::path_to_url(git_relative_path);
+        ctx["source"]["full_path"] = file.string();
+        ctx["source"]["name"] = file.filename().string();
+        ctx["source"]["line"] = e.line();
     }
 
     const auto maybe_comment = e.comment();
     if (maybe_comment) {
-        ctx["element"]["comment"] = maybe_comment.value();
+        ctx["comment"] = maybe_comment.value();
     }
 
     return ctx;
 }
 
+template <typename C, typename D>
+const inja::Template &generator<C, D>::parse_template(
+    const std::string &tmpl) const
+{
+    auto it = m_templates.find(tmpl);
+    if (it == m_templates.end())
+        it = m_templates.emplace(tmpl, env().parse(tmpl)).first;
+
+    return it->second;
+}
+
+template <typename C, typename D>
+template <typename E>
+std::string generator<C, D>::render_element_template(
+    const std::string &tmpl, const E &e) const
+{
+    const auto &parsed = parse_template(tmpl);
+
+    m_context["element"] = element_only_context(e);
+
+    try {
+        auto result = env().render(parsed, m_context);
+        m_context.erase("element");
+        return result;
+    }
+    catch (...) {
+        m_context.erase("element");
+        throw;
+    }
+}
+
 template <typename C, typename D>
 void generator<C, D>::generate(std::ostream &ostr) const
 {
@@ -290,8 +350,7 @@ void generator<C, D>::generate_link(std::ostream &ostr, const E &e) const
     try {
         std::string link{};
         if (!config.generate_links().link.empty()) {
-            link = env().render(std::string_view{config.generate_links().link},
-                element_context(e));
+            link = render_element_template(config.generate_links().link, e);
         }
         if (link.empty())
             link = " ";
@@ -313,8 +372,7 @@ void generator<C, D>::generate_link(std::ostream &ostr, const E &e) const
         ostr << " \"";
         try {
             auto tooltip_text =
-                env().render(std::string_view{config.generate_links().tooltip},
-                    element_context(e));
+                render_element_template(config.generate_links().tooltip, e);
             util::replace_all(tooltip_text, "\"", "&bdquo;");
             ostr << tooltip_text;
         }
@@ -347,7 +405,7 @@ void generator<C, D>::generate_mermaid_directives(
     for (const auto &d : directives) {
         try {
             // Render the directive with template engine first
-            std::string directive{env().render(std::string_view{d}, context())};
+            std::string directive{env().render(parse_template(d), context())};
 
             // Now search for alias `@A()` directives in the text
             // (this is deprecated)
@@ -53,6 +53,7 @@ void diagram::set_name(const std::string &name) { name_ = name; }
 void diagram::set_filter(std::unique_ptr<diagram_filter> filter)
 {
     filter_ = std::move(filter);
+    namespace_verdicts_.clear();
 }
 
 void diagram::set_complete(bool complete) { complete_ = complete; }
@@ -75,7 +76,19 @@ bool diagram::should_include(const namespace_ &ns) const
     if (filter_.get() == nullptr)
         return true;
 
-    return filter_->should_include(ns);
+    // Namespace filters do not depend on the diagram contents, so their
+    // verdicts can be reused
+    auto name = ns.to_string();
+
+    if (auto it = namespace_verdicts_.find(name);
+        it != namespace_verdicts_.end())
+        return it->second;
+
+    const auto result = filter_->should_include(ns);
+
+    namespace_verdicts_.emplace(std::move(name), result);
+
+    return result;
 }
 
 bool diagram::should_include(relationship r) const
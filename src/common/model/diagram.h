@@ -24,6 +24,7 @@
 
 #include <memory>
 #include <string>
+#include <unordered_map>
 
 namespace clanguml::common::model {
 
@@ -175,6 +176,10 @@ private:
     std::string name_;
     std::unique_ptr<diagram_filter> filter_;
     bool complete_{false};
+
+    // Namespace filter verdicts by namespace name, shared by all translation
+    // units visited into this diagram
+    mutable std::unordered_map<std::string, bool> namespace_verdicts_;
 };
 
 template <typename DiagramT> bool check_diagram_type(diagram_t t);
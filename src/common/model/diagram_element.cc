@@ -24,6 +24,20 @@
 
 namespace clanguml::common::model {
 
+namespace {
+/**
+ * Hash of the relationship properties compared by relationship equality,
+ * i.e. type, destination and label.
+ */
+std::uint64_t relationship_key(const relationship &r)
+{
+    const auto seed = r.destination().value() * 31U +
+        static_cast<std::uint64_t>(r.type());
+
+    return util::hash64(r.label(), seed);
+}
+} // namespace
+
 diagram_element::diagram_element() = default;
 
 const eid_t &diagram_element::id() const { return id_; }
@@ -57,16 +71,47 @@ void diagram_element::add_relationship(relationship &&cr)
         return;
     }
 
-    if (!util::contains(relationships_, cr)) {
-        LOG_DBG("Adding relationship from: '{}' ({}) - {} - '{}'", id(),
-            full_name(true), to_string(cr.type()), cr.destination());
+    if (has_relationship(cr))
+        return;
+
+    LOG_DBG("Adding relationship from: '{}' ({}) - {} - '{}'", id(),
+        full_name(true), to_string(cr.type()), cr.destination());
+
+    relationship_index_.emplace(relationship_key(cr), relationships_.size());
+    relationships_.emplace_back(std::move(cr));
+}
+
+bool diagram_element::has_relationship(const relationship &cr)
+{
+    reindex_relationships();
 
-        relationships_.emplace_back(std::move(cr));
+    auto [first, last] = relationship_index_.equal_range(relationship_key(cr));
+    for (auto it = first; it != last; ++it) {
+        if (relationships_[it->second] == cr)
+            return true;
     }
+
+    return false;
+}
+
+void diagram_element::reindex_relationships()
+{
+    if (relationship_index_valid_)
+        return;
+
+    relationship_index_.clear();
+    relationship_index_.reserve(relationships_.size());
+    for (auto i = 0U; i < relationships_.size(); i++)
+        relationship_index_.emplace(relationship_key(relationships_[i]), i);
+
+    relationship_index_valid_ = true;
 }
 
 std::vector<relationship> &diagram_element::relationships()
 {
+    // Relationships can be modified or removed through the returned reference
+    relationship_index_valid_ = false;
+
     return relationships_;
 }
 
@@ -102,6 +147,12 @@ bool diagram_element::complete() const { return complete_; }
 
 void diagram_element::complete(bool completed) { complete_ = completed; }
 
+void diagram_element::invalidate_full_name_cache()
+{
+    for (auto &full_name : full_name_cache_)
+        full_name.reset();
+}
+
 bool operator==(const diagram_element &l, const diagram_element &r)
 {
     return l.id() == r.id();
@@ -20,13 +20,18 @@
 #include "decorated_element.h"
 #include "relationship.h"
 #include "source_location.h"
+#include "util/interned_string.h"
 #include "util/util.h"
 
 #include <inja/inja.hpp>
 
+#include <array>
 #include <atomic>
+#include <cstdint>
 #include <exception>
+#include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace clanguml::common::model {
@@ -90,14 +95,18 @@ public:
      *
      * @param name Elements name.
      */
-    void set_name(const std::string &name) { name_ = name; }
+    void set_name(const std::string &name)
+    {
+        name_ = util::interned_string{name};
+        invalidate_full_name_cache();
+    }
 
     /**
      * Return diagram element name.
      *
      * @return Diagram element name.
      */
-    std::string name() const { return name_; }
+    std::string name() const { return name_.str(); }
 
     /**
      * Return the type name of the diagram element.
@@ -119,6 +128,9 @@ public:
     /**
      * Return all relationships outgoing from this element.
      *
+     * Relationships modified through the returned reference are reindexed
+     * on the next call to `add_relationship()`.
+     *
      * @return List of relationships.
      */
     std::vector<relationship> &relationships();
@@ -133,6 +145,8 @@ public:
     /**
      * Add relationships, whose source is this element.
      *
+     * Relationships equal to an already added relationship are ignored.
+     *
      * @param cr Relationship to another diagram element.
      */
     void add_relationship(relationship &&cr);
@@ -184,12 +198,63 @@ public:
      */
     void complete(bool completed);
 
+protected:
+    /**
+     * @brief Kinds of cached element full names
+     */
+    enum class full_name_t { kRelative, kAbsolute, kNoNamespace };
+
+    /**
+     * @brief Get cached full name of the element, rendering it if necessary
+     *
+     * Rendering full names of some elements (e.g. class templates) is
+     * expensive, and they are requested many times by diagram filters and
+     * generators. Cached names are invalidated whenever the name, namespace
+     * or template parameters of the element change.
+     *
+     * @tparam F Type of functor rendering the full name
+     * @param kind Kind of the full name
+     * @param render Functor rendering the full name
+     * @return Full name of the element
+     */
+    template <typename F>
+    std::string cached_full_name(full_name_t kind, F &&render) const
+    {
+        auto &full_name = full_name_cache_.at(static_cast<std::size_t>(kind));
+        if (!full_name)
+            full_name = render();
+
+        return *full_name;
+    }
+
+    /**
+     * @brief Invalidate cached full names of the element
+     */
+    void invalidate_full_name_cache();
+
 private:
+    /**
+     * @brief Find relationship equal to `cr` using the relationship index
+     *
+     * @param cr Relationship
+     * @return True, if an equal relationship has already been added
+     */
+    bool has_relationship(const relationship &cr);
+
+    /**
+     * @brief Rebuild relationship index, if the relationships could have
+     *        been modified since it was built
+     */
+    void reindex_relationships();
+
     eid_t id_{};
     std::optional<eid_t> parent_element_id_{};
-    std::string name_;
+    util::interned_string name_;
     std::vector<relationship> relationships_;
+    std::unordered_multimap<std::uint64_t, std::size_t> relationship_index_;
+    bool relationship_index_valid_{true};
     bool nested_{false};
     bool complete_{false};
+    mutable std::array<std::optional<std::string>, 3> full_name_cache_;
 };
 } // namespace clanguml::common::model
@@ -18,6 +18,7 @@
 
 #include "diagram_filter.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "class_diagram/model/class.h"
@@ -29,6 +30,39 @@
 
 namespace clanguml::common::model {
 
+namespace {
+/**
+ * Make a key of an absolute path, such that path `a` is a prefix of path `b`
+ * in the sense of util::starts_with() if and only if the key of `a` is
+ * a string prefix of the key of `b`.
+ */
+std::string make_path_prefix_key(const std::filesystem::path &p)
+{
+    std::filesystem::path normal_path;
+    for (const auto &element : p.relative_path().lexically_normal()) {
+        if (!element.empty())
+            normal_path /= element;
+    }
+
+    return p.root_name().string() + '\0' + normal_path.string();
+}
+
+/**
+ * Check if regex pattern contains back references, whose numbering would
+ * change if the pattern was combined with other patterns.
+ */
+bool has_back_reference(const std::string &pattern)
+{
+    for (auto i = 1U; i < pattern.size(); i++) {
+        if (pattern[i - 1] == '\\' &&
+            ((pattern[i] >= '1' && pattern[i] <= '9') || pattern[i] == 'k'))
+            return true;
+    }
+
+    return false;
+}
+} // namespace
+
 namespace detail {
 
 template <>
@@ -79,14 +113,29 @@ const clanguml::common::optional_ref<common::model::source_file> get(
 {
     return d.find<source_file>(full_name);
 }
+} // namespace detail
 
-template <>
-eid_t destination_comparator<common::model::source_file>(
-    const common::model::source_file &f)
+namespace {
+/**
+ * @brief Build graph of inheritance relationships between classes
+ *
+ * Each class has an outgoing kExtension edge to each of its base classes.
+ */
+relationship_graph inheritance_graph(const class_diagram::model::diagram &cd)
 {
-    return f.id();
+    relationship_graph graph;
+
+    for (const auto &c : cd.classes()) {
+        graph.add_node(c.get().id());
+
+        for (const auto &p : c.get().parents()) {
+            graph.add_edge(c.get().id(), p.id(), relationship_t::kExtension);
+        }
+    }
+
+    return graph;
 }
-} // namespace detail
+} // namespace
 
 filter_visitor::filter_visitor(filter_t type)
     : type_{type}
@@ -187,102 +236,149 @@ tvl::value_t anyof_filter::match(
         [&d, &e](const auto &f) { return f->match(d, e); });
 }
 
-namespace_filter::namespace_filter(
-    filter_t type, std::vector<common::namespace_or_regex> namespaces)
-    : filter_visitor{type}
-    , namespaces_{std::move(namespaces)}
+namespace_filter::namespace_trie::namespace_trie()
+    : nodes_(1)
 {
 }
 
-tvl::value_t namespace_filter::match(
-    const diagram & /*d*/, const namespace_ &ns) const
+void namespace_filter::namespace_trie::add(const namespace_ &ns)
 {
-    if (ns.is_empty())
-        return {};
+    std::size_t current{0};
+    for (const auto &name : ns) {
+        auto [it, inserted] =
+            nodes_[current].children.try_emplace(name, nodes_.size());
+        current = it->second;
+        if (inserted)
+            nodes_.emplace_back();
+    }
 
-    return tvl::any_of(namespaces_.begin(), namespaces_.end(),
-        [&ns, is_inclusive = is_inclusive()](const auto &nsit) {
-            if (std::holds_alternative<namespace_>(nsit.value())) {
-                const auto &ns_pattern = std::get<namespace_>(nsit.value());
-                if (is_inclusive)
-                    return ns.starts_with(ns_pattern) ||
-                        ns_pattern.starts_with(ns);
+    nodes_[current].terminal = true;
+}
 
-                return ns.starts_with(ns_pattern);
-            }
+bool namespace_filter::namespace_trie::has_prefix_of(const namespace_ &ns) const
+{
+    std::size_t current{0};
+    for (const auto &name : ns) {
+        if (nodes_[current].terminal)
+            return true;
 
-            const auto &regex = std::get<common::regex>(nsit.value());
-            return regex %= ns.to_string();
-        });
+        auto it = nodes_[current].children.find(name);
+        if (it == nodes_[current].children.end())
+            return false;
+
+        current = it->second;
+    }
+
+    return nodes_[current].terminal;
 }
 
-tvl::value_t namespace_filter::match(const diagram &d, const element &e) const
+bool namespace_filter::namespace_trie::is_prefix_of_any(
+    const namespace_ &ns) const
 {
-    if (d.type() != diagram_t::kPackage &&
-        dynamic_cast<const package *>(&e) != nullptr) {
-        auto result = tvl::any_of(namespaces_.begin(), namespaces_.end(),
-            [&e, is_inclusive = is_inclusive()](const auto &nsit) {
-                if (std::holds_alternative<namespace_>(nsit.value())) {
-                    const auto &ns_pattern = std::get<namespace_>(nsit.value());
+    std::size_t current{0};
+    for (const auto &name : ns) {
+        auto it = nodes_[current].children.find(name);
+        if (it == nodes_[current].children.end())
+            return false;
 
-                    auto element_full_name_starts_with_namespace =
-                        namespace_{e.name_and_ns()}.starts_with(ns_pattern);
+        current = it->second;
+    }
+
+    // Every node in the tree, except for the root of an empty tree, is
+    // a prefix of at least one pattern
+    return current != 0 || nodes_.size() > 1 || nodes_.front().terminal;
+}
 
-                    auto element_full_name_equals_pattern =
-                        namespace_{e.name_and_ns()} == ns_pattern;
+namespace_filter::namespace_filter(
+    filter_t type, std::vector<common::namespace_or_regex> namespaces)
+    : filter_visitor{type}
+    , namespaces_{std::move(namespaces)}
+{
+    std::vector<std::string> combined_patterns;
 
-                    auto pattern_starts_with_element_full_name =
-                        ns_pattern.starts_with(namespace_{e.name_and_ns()});
+    for (const auto &nsit : namespaces_) {
+        if (std::holds_alternative<namespace_>(nsit.value())) {
+            literals_.add(std::get<namespace_>(nsit.value()));
+            continue;
+        }
 
-                    auto result = element_full_name_starts_with_namespace ||
-                        element_full_name_equals_pattern;
+        const auto &regex = std::get<common::regex>(nsit.value());
+        if (has_back_reference(regex.pattern))
+            regexes_.emplace_back(regex);
+        else
+            combined_patterns.emplace_back("(?:" + regex.pattern + ")");
+    }
 
-                    if (is_inclusive)
-                        result =
-                            result || pattern_starts_with_element_full_name;
+    if (combined_patterns.empty())
+        return;
 
-                    return result;
-                }
+    try {
+        combined_regex_ = std::regex(util::join(combined_patterns, "|"));
+    }
+    catch (const std::regex_error &e) {
+        LOG_WARN("Failed to combine namespace filter patterns: {}", e.what());
 
-                return std::get<common::regex>(nsit.value()) %=
-                    e.full_name(false);
-            });
+        for (const auto &nsit : namespaces_) {
+            if (!std::holds_alternative<common::regex>(nsit.value()))
+                continue;
 
-        return result;
+            const auto &regex = std::get<common::regex>(nsit.value());
+            if (!has_back_reference(regex.pattern))
+                regexes_.emplace_back(regex);
+        }
     }
+}
 
-    if (d.type() == diagram_t::kPackage) {
-        auto result = tvl::any_of(namespaces_.begin(), namespaces_.end(),
-            [&e, is_inclusive = is_inclusive()](const auto &nsit) {
-                if (std::holds_alternative<namespace_>(nsit.value())) {
-                    auto e_ns = namespace_{e.full_name(false)};
-                    auto nsit_ns = std::get<namespace_>(nsit.value());
+bool namespace_filter::matches_literal(
+    const namespace_ &ns, bool match_parents) const
+{
+    return literals_.has_prefix_of(ns) ||
+        (match_parents && literals_.is_prefix_of_any(ns));
+}
 
-                    if (is_inclusive)
-                        return e_ns.starts_with(nsit_ns) ||
-                            nsit_ns.starts_with(e_ns) || e_ns == nsit_ns;
+bool namespace_filter::has_regexes() const
+{
+    return combined_regex_.has_value() || !regexes_.empty();
+}
 
-                    return e_ns.starts_with(nsit_ns) || e_ns == nsit_ns;
-                }
+bool namespace_filter::matches_regex(const std::string &name) const
+{
+    if (combined_regex_ && std::regex_match(name, *combined_regex_))
+        return true;
 
-                return std::get<common::regex>(nsit.value()) %=
-                    e.full_name(false);
-            });
+    return std::any_of(regexes_.begin(), regexes_.end(),
+        [&name](const auto &regex) { return regex %= name; });
+}
 
-        return result;
-    }
+tvl::value_t namespace_filter::match(
+    const diagram & /*d*/, const namespace_ &ns) const
+{
+    if (ns.is_empty() || namespaces_.empty())
+        return {};
 
-    auto result = tvl::any_of(
-        namespaces_.begin(), namespaces_.end(), [&e](const auto &nsit) {
-            if (std::holds_alternative<namespace_>(nsit.value())) {
-                return e.get_namespace().starts_with(
-                    std::get<namespace_>(nsit.value()));
-            }
+    return matches_literal(ns, is_inclusive()) ||
+        (has_regexes() && matches_regex(ns.to_string()));
+}
 
-            return std::get<common::regex>(nsit.value()) %= e.full_name(false);
-        });
+tvl::value_t namespace_filter::match(const diagram &d, const element &e) const
+{
+    if (namespaces_.empty())
+        return {};
 
-    return result;
+    if (d.type() != diagram_t::kPackage &&
+        dynamic_cast<const package *>(&e) != nullptr) {
+        return matches_literal(namespace_{e.name_and_ns()}, is_inclusive()) ||
+            (has_regexes() && matches_regex(e.full_name(false)));
+    }
+
+    if (d.type() == diagram_t::kPackage) {
+        return matches_literal(
+                   namespace_{e.full_name(false)}, is_inclusive()) ||
+            (has_regexes() && matches_regex(e.full_name(false)));
+    }
+
+    return matches_literal(e.get_namespace(), false) ||
+        (has_regexes() && matches_regex(e.full_name(false)));
 }
 
 modules_filter::modules_filter(
@@ -506,6 +602,29 @@ subclass_filter::subclass_filter(
 {
 }
 
+void subclass_filter::initialize(const class_diagram::model::diagram &cd) const
+{
+    if (initialized_)
+        return;
+
+    initialized_ = true;
+
+    std::unordered_set<eid_t> roots;
+    for (const auto &root : roots_) {
+        for (const auto &maybe_root :
+            cd.find<class_diagram::model::class_>(root)) {
+            if (maybe_root)
+                roots.emplace(maybe_root.value().id());
+        }
+    }
+
+    if (roots.empty())
+        return;
+
+    subclasses_ = inheritance_graph(cd).reachable(
+        roots, 0, relationship_mask(relationship_t::kExtension));
+}
+
 tvl::value_t subclass_filter::match(const diagram &d, const element &e) const
 {
     if (d.type() != diagram_t::kClass)
@@ -519,8 +638,7 @@ tvl::value_t subclass_filter::match(const diagram &d, const element &e) const
 
     const auto &cd = dynamic_cast<const class_diagram::model::diagram &>(d);
 
-    // First get all parents of element e
-    clanguml::common::reference_set<class_diagram::model::class_> parents;
+    initialize(cd);
 
     const auto &fn = e.full_name(false);
     auto class_ref = cd.find<class_diagram::model::class_>(fn);
@@ -528,26 +646,9 @@ tvl::value_t subclass_filter::match(const diagram &d, const element &e) const
     if (!class_ref.has_value())
         return false;
 
-    parents.emplace(class_ref.value());
-
-    cd.get_parents(parents);
-
-    std::vector<std::string> parents_names;
-    for (const auto p : parents)
-        parents_names.push_back(p.get().full_name(false));
-
-    // Now check if any of the parents matches the roots specified in the
-    // filter config
-    for (const auto &root : roots_) {
-        for (const auto &parent : parents) {
-            auto full_name = parent.get().full_name(false);
-            if (root == full_name) {
-                return true;
-            }
-        }
-    }
-
-    return false;
+    // Check if the element is one of the roots specified in the filter
+    // config, or any of their subclasses
+    return subclasses_.count(class_ref.value().id()) > 0;
 }
 
 parents_filter::parents_filter(
@@ -557,6 +658,29 @@ parents_filter::parents_filter(
 {
 }
 
+void parents_filter::initialize(const class_diagram::model::diagram &cd) const
+{
+    if (initialized_)
+        return;
+
+    initialized_ = true;
+
+    std::unordered_set<eid_t> children;
+    for (const auto &child_pattern : children_) {
+        for (const auto &child :
+            cd.find<class_diagram::model::class_>(child_pattern)) {
+            if (child.has_value())
+                children.emplace(child.value().id());
+        }
+    }
+
+    if (children.empty())
+        return;
+
+    parents_ = inheritance_graph(cd).reachable(
+        children, relationship_mask(relationship_t::kExtension), 0);
+}
+
 tvl::value_t parents_filter::match(const diagram &d, const element &e) const
 {
     if (d.type() != diagram_t::kClass)
@@ -568,28 +692,9 @@ tvl::value_t parents_filter::match(const diagram &d, const element &e) const
     if (!d.complete())
         return {};
 
-    const auto &cd = dynamic_cast<const class_diagram::model::diagram &>(d);
-
-    // First get all parents of element e
-    clanguml::common::reference_set<class_diagram::model::class_> parents;
-
-    for (const auto &child_pattern : children_) {
-        auto child_refs = cd.find<class_diagram::model::class_>(child_pattern);
-
-        for (auto &child : child_refs) {
-            if (child.has_value())
-                parents.emplace(child.value());
-        }
-    }
-
-    cd.get_parents(parents);
-
-    for (const auto &parent : parents) {
-        if (e == parent.get())
-            return true;
-    }
+    initialize(dynamic_cast<const class_diagram::model::diagram &>(d));
 
-    return false;
+    return parents_.count(e.id()) > 0;
 }
 
 relationship_filter::relationship_filter(
@@ -652,149 +757,83 @@ context_filter::context_filter(
 }
 
 void context_filter::initialize_effective_context(
-    const diagram &d, unsigned idx) const
+    const diagram &d, const relationship_graph &graph, unsigned idx) const
 {
-    bool effective_context_extended{true};
-
-    auto &effective_context = effective_contexts_[idx];
+    const auto &cd = dynamic_cast<const class_diagram::model::diagram &>(d);
 
     // First add to effective context all elements matching context_ patterns
     const auto &context_cfg = context_.at(idx);
-    const auto &context_matches =
-        dynamic_cast<const class_diagram::model::diagram &>(d)
-            .find<class_diagram::model::class_>(context_cfg.pattern);
 
-    for (const auto &maybe_match : context_matches) {
+    std::unordered_set<eid_t> roots;
+
+    for (const auto &maybe_match :
+        cd.find<class_diagram::model::class_>(context_cfg.pattern)) {
         if (maybe_match)
-            effective_context.emplace(maybe_match.value().id());
+            roots.emplace(maybe_match.value().id());
     }
 
-    const auto &context_enum_matches =
-        dynamic_cast<const class_diagram::model::diagram &>(d)
-            .find<class_diagram::model::enum_>(context_cfg.pattern);
-
-    for (const auto &maybe_match : context_enum_matches) {
+    for (const auto &maybe_match :
+        cd.find<class_diagram::model::enum_>(context_cfg.pattern)) {
         if (maybe_match)
-            effective_context.emplace(maybe_match.value().id());
+            roots.emplace(maybe_match.value().id());
     }
 
-    const auto &context_concept_matches =
-        dynamic_cast<const class_diagram::model::diagram &>(d)
-            .find<class_diagram::model::concept_>(context_cfg.pattern);
-
-    for (const auto &maybe_match : context_concept_matches) {
+    for (const auto &maybe_match :
+        cd.find<class_diagram::model::concept_>(context_cfg.pattern)) {
         if (maybe_match)
-            effective_context.emplace(maybe_match.value().id());
+            roots.emplace(maybe_match.value().id());
     }
 
-    // Now repeat radius times - extend the effective context with elements
-    // matching in direct relationship to what is in context
-    auto radius_counter = context_cfg.radius;
-    std::set<eid_t> current_iteration_context;
-
-    while (radius_counter > 0 && effective_context_extended) {
-        // If at any iteration the effective context was not extended - we
-        // don't to need to continue
-        radius_counter--;
-        effective_context_extended = false;
-        current_iteration_context.clear();
-
-        // For each class in the model
-        find_elements_in_direct_relationship<class_diagram::model::class_>(
-            d, context_cfg, effective_context, current_iteration_context);
-
-        find_elements_inheritance_relationship(
-            d, context_cfg, effective_context, current_iteration_context);
-
-        // For each concept in the model
-        find_elements_in_direct_relationship<class_diagram::model::concept_>(
-            d, context_cfg, effective_context, current_iteration_context);
-
-        // For each enum in the model
-        find_elements_in_direct_relationship<class_diagram::model::enum_>(
-            d, context_cfg, effective_context, current_iteration_context);
-
-        for (auto id : current_iteration_context) {
-            if (effective_context.count(id) == 0) {
-                // Found new element to add to context
-                effective_context.emplace(id);
-                effective_context_extended = true;
-            }
-        }
+    // Calculate which relationships should be followed from elements in the
+    // context (outgoing) and to elements in the context (incoming).
+    // At the moment aggregation and composition are added in the model in
+    // reverse direction, so their direction has to be swapped.
+    const auto aggregation_mask =
+        relationship_mask(relationship_t::kAggregation) |
+        relationship_mask(relationship_t::kComposition);
+
+    relationship_mask_t mask{0};
+    for (auto r = relationship_t::kNone; r <= relationship_t::kConstraint;
+         r = static_cast<relationship_t>(static_cast<int>(r) + 1)) {
+        if (r != relationship_t::kExtension && should_include(context_cfg, r) &&
+            d.should_include(r))
+            mask |= relationship_mask(r);
     }
-}
 
-bool context_filter::should_include(
-    const config::context_config &context_cfg, relationship_t r) const
-{
-    return context_cfg.relationships.empty() ||
-        util::contains(context_cfg.relationships, r);
-}
+    relationship_mask_t outgoing_mask{mask};
+    relationship_mask_t incoming_mask{mask};
 
-void context_filter::find_elements_inheritance_relationship(const diagram &d,
-    const config::context_config &context_cfg,
-    std::set<eid_t> &effective_context,
-    std::set<eid_t> &current_iteration_context) const
-{
-    const auto &cd = dynamic_cast<const class_diagram::model::diagram &>(d);
-
-    if (!should_include(context_cfg, relationship_t::kExtension)) {
-        return;
+    if (context_cfg.direction == config::context_direction_t::inward) {
+        outgoing_mask &= aggregation_mask;
+        incoming_mask &= ~aggregation_mask;
+    }
+    else if (context_cfg.direction == config::context_direction_t::outward) {
+        outgoing_mask &= ~aggregation_mask;
+        incoming_mask &= aggregation_mask;
     }
 
-    for (const auto &c : cd.classes()) {
-        // Check if any of the elements parents are already in the
-        // effective context...
-        if (context_cfg.direction != config::context_direction_t::outward)
-            find_elements_base_classes(
-                d, effective_context, current_iteration_context, cd, c);
+    // Inheritance is represented in the graph by edges from subclasses to
+    // their base classes
+    if (should_include(context_cfg, relationship_t::kExtension)) {
+        if (context_cfg.direction != config::context_direction_t::outward &&
+            d.should_include(relationship_t::kExtension))
+            incoming_mask |= relationship_mask(relationship_t::kExtension);
 
-        // .. or vice-versa
         if (context_cfg.direction != config::context_direction_t::inward)
-            find_elements_sub_classes(
-                effective_context, current_iteration_context, cd, c);
+            outgoing_mask |= relationship_mask(relationship_t::kExtension);
     }
-}
-
-void context_filter::find_elements_sub_classes(
-    std::set<eid_t> &effective_context,
-    std::set<eid_t> &current_iteration_context,
-    const class_diagram::model::diagram &cd,
-    const std::reference_wrapper<class_diagram::model::class_> &c) const
-{
-    for (const auto &ec : effective_context) {
-        const auto &maybe_child = cd.find<class_diagram::model::class_>(ec);
-
-        // The element might not exist because it might have been
-        // something other than a class
-        if (!maybe_child)
-            continue;
 
-        for (const auto &p : maybe_child.value().parents()) {
-            if (p.name() == c.get().full_name(false)) {
-                current_iteration_context.emplace(c.get().id());
-            }
-        }
-    }
+    // Now extend the effective context radius times with elements in direct
+    // relationship to what is already in the context
+    effective_contexts_[idx] = graph.reachable(
+        roots, outgoing_mask, incoming_mask, context_cfg.radius);
 }
-void context_filter::find_elements_base_classes(const diagram &d,
-    std::set<eid_t> &effective_context,
-    std::set<eid_t> &current_iteration_context,
-    const class_diagram::model::diagram &cd,
-    const std::reference_wrapper<class_diagram::model::class_> &c) const
-{
-    for (const class_diagram::model::class_parent &p : c.get().parents()) {
-        for (const auto &ec : effective_context) {
-            const auto &maybe_parent =
-                cd.find<class_diagram::model::class_>(ec);
-            if (!maybe_parent)
-                continue;
 
-            if (d.should_include(relationship_t::kExtension) &&
-                maybe_parent.value().full_name(false) == p.name())
-                current_iteration_context.emplace(c.get().id());
-        }
-    }
+bool context_filter::should_include(
+    const config::context_config &context_cfg, relationship_t r) const
+{
+    return context_cfg.relationships.empty() ||
+        util::contains(context_cfg.relationships, r);
 }
 
 void context_filter::initialize(const diagram &d) const
@@ -804,10 +843,27 @@ void context_filter::initialize(const diagram &d) const
 
     initialized_ = true;
 
+    const auto &cd = dynamic_cast<const class_diagram::model::diagram &>(d);
+
+    // Build the relationship graph once for all contexts
+    relationship_graph graph;
+    graph.add_elements(cd.classes());
+    graph.add_elements(cd.enums());
+    graph.add_elements(cd.concepts());
+
+    for (const auto &c : cd.classes()) {
+        for (const auto &p : c.get().parents()) {
+            if (auto parent = cd.find<class_diagram::model::class_>(p.name());
+                parent)
+                graph.add_edge(c.get().id(), parent.value().id(),
+                    relationship_t::kExtension);
+        }
+    }
+
     // Prepare effective_contexts_
+    effective_contexts_.resize(context_.size());
     for (auto i = 0U; i < context_.size(); i++) {
-        effective_contexts_.push_back({}); // NOLINT
-        initialize_effective_context(d, i);
+        initialize_effective_context(d, graph, i);
     }
 }
 
@@ -873,7 +929,8 @@ paths_filter::paths_filter(filter_t type, const std::filesystem::path &root,
                 LOG_DBG("Added path {} to paths_filter",
                     resolved_absolute_path.string());
 
-                paths_.emplace_back(std::move(resolved_absolute_path));
+                prefixes_.emplace_back(
+                    make_path_prefix_key(resolved_absolute_path));
 
                 match_successful = true;
             }
@@ -890,12 +947,34 @@ paths_filter::paths_filter(filter_t type, const std::filesystem::path &root,
                      "any files relative to '{}'",
                 path, root_.string());
     }
+
+    // Remove prefixes extending other prefixes, after which the only prefix
+    // of a path can be its predecessor in the sorted array
+    std::sort(prefixes_.begin(), prefixes_.end());
+
+    std::vector<std::string> prefixes;
+    for (auto &prefix : prefixes_) {
+        if (prefixes.empty() || !util::starts_with(prefix, prefixes.back()))
+            prefixes.emplace_back(std::move(prefix));
+    }
+    prefixes_ = std::move(prefixes);
+}
+
+bool paths_filter::matches(const std::filesystem::path &p) const
+{
+    const auto key = make_path_prefix_key(p);
+
+    auto it = std::upper_bound(prefixes_.begin(), prefixes_.end(), key);
+    if (it == prefixes_.begin())
+        return false;
+
+    return util::starts_with(key, *std::prev(it));
 }
 
 tvl::value_t paths_filter::match(
     const diagram & /*d*/, const common::model::source_file &p) const
 {
-    if (paths_.empty()) {
+    if (prefixes_.empty()) {
         return {};
     }
 
@@ -904,22 +983,13 @@ tvl::value_t paths_filter::match(
         return {};
     }
 
-    auto pp = p.fs_path(root_);
-    for (const auto &path : paths_) {
-        if (pp.root_name().string() == path.root_name().string() &&
-            util::starts_with(pp.relative_path(), path.relative_path())) {
-
-            return true;
-        }
-    }
-
-    return false;
+    return matches(p.fs_path(root_));
 }
 
 tvl::value_t paths_filter::match(
     const diagram & /*d*/, const common::model::source_location &p) const
 {
-    if (paths_.empty()) {
+    if (prefixes_.empty()) {
         return {};
     }
 
@@ -931,15 +1001,7 @@ tvl::value_t paths_filter::match(
         return {};
     }
 
-    for (const auto &path : paths_) {
-        if (sl_path.root_name().string() == path.root_name().string() &&
-            util::starts_with(sl_path.relative_path(), path.relative_path())) {
-
-            return true;
-        }
-    }
-
-    return false;
+    return matches(sl_path);
 }
 
 class_method_filter::class_method_filter(filter_t type,
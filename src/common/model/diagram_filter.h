@@ -25,6 +25,7 @@
 #include "common/model/element.h"
 #include "common/model/enums.h"
 #include "common/model/namespace.h"
+#include "common/model/relationship_graph.h"
 #include "config/config.h"
 #include "diagram.h"
 #include "include_diagram/model/diagram.h"
@@ -33,6 +34,10 @@
 #include "tvl.h"
 
 #include <filesystem>
+#include <optional>
+#include <regex>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 
 namespace clanguml::common::model {
@@ -56,13 +61,6 @@ const clanguml::common::reference_vector<ElementT> &view(const DiagramT &d);
 template <typename ElementT, typename DiagramT>
 const clanguml::common::optional_ref<ElementT> get(
     const DiagramT &d, const std::string &full_name);
-
-template <typename ElementT> eid_t destination_comparator(const ElementT &e)
-{
-    return e.id();
-}
-
-template <> eid_t destination_comparator(const common::model::source_file &f);
 } // namespace detail
 
 /**
@@ -139,6 +137,13 @@ private:
 /**
  * Match namespace or diagram element to a set of specified namespaces or
  * regex patterns.
+ *
+ * Literal namespaces are compiled into a prefix tree, so matching them does
+ * not depend on the number of configured namespaces. Regex patterns are
+ * combined into a single regular expression, which avoids the overhead of
+ * matching each pattern separately, although std::regex still tries each
+ * alternative in turn, so the cost of matching still grows with the number
+ * of regex patterns.
  */
 struct namespace_filter : public filter_visitor {
     namespace_filter(
@@ -151,7 +156,75 @@ struct namespace_filter : public filter_visitor {
     tvl::value_t match(const diagram &d, const element &e) const override;
 
 private:
+    /**
+     * @brief Prefix tree of literal namespace patterns
+     */
+    class namespace_trie {
+    public:
+        namespace_trie();
+
+        /**
+         * @brief Add namespace pattern to the tree
+         *
+         * @param ns Namespace pattern
+         */
+        void add(const namespace_ &ns);
+
+        /**
+         * @brief Check if any pattern is a prefix of `ns`
+         *
+         * @param ns Namespace
+         * @return True, if `ns` starts with any of the patterns
+         */
+        bool has_prefix_of(const namespace_ &ns) const;
+
+        /**
+         * @brief Check if `ns` is a prefix of any pattern
+         *
+         * @param ns Namespace
+         * @return True, if any of the patterns starts with `ns`
+         */
+        bool is_prefix_of_any(const namespace_ &ns) const;
+
+    private:
+        struct node {
+            std::unordered_map<std::string, std::size_t> children;
+            bool terminal{false};
+        };
+
+        std::vector<node> nodes_;
+    };
+
+    /**
+     * @brief Match namespace against the literal namespace patterns
+     *
+     * @param ns Namespace
+     * @param match_parents Whether parents of the patterns also match
+     * @return True, if the namespace matches any of the literal patterns
+     */
+    bool matches_literal(const namespace_ &ns, bool match_parents) const;
+
+    /**
+     * @brief Check if any regex patterns are configured
+     *
+     * @return True, if the filter contains regex patterns
+     */
+    bool has_regexes() const;
+
+    /**
+     * @brief Match name against the regex patterns
+     *
+     * @param name Fully qualified name
+     * @return True, if the name matches any of the regex patterns
+     */
+    bool matches_regex(const std::string &name) const;
+
     std::vector<common::namespace_or_regex> namespaces_;
+    namespace_trie literals_;
+    /*! Alternation of all regex patterns, which can be safely combined */
+    std::optional<std::regex> combined_regex_;
+    /*! Regex patterns with back references, matched separately */
+    std::vector<common::regex> regexes_;
 };
 
 /**
@@ -244,7 +317,15 @@ struct subclass_filter : public filter_visitor {
     tvl::value_t match(const diagram &d, const element &e) const override;
 
 private:
+    void initialize(const class_diagram::model::diagram &cd) const;
+
     std::vector<common::string_or_regex> roots_;
+
+    /*! Ids of all subclasses of the roots, including the roots */
+    mutable std::unordered_set<eid_t> subclasses_;
+
+    /*! Flag to mark whether the subclasses have been computed */
+    mutable bool initialized_{false};
 };
 
 /**
@@ -259,7 +340,15 @@ struct parents_filter : public filter_visitor {
     tvl::value_t match(const diagram &d, const element &e) const override;
 
 private:
+    void initialize(const class_diagram::model::diagram &cd) const;
+
     std::vector<common::string_or_regex> children_;
+
+    /*! Ids of all parents of the children, including the children */
+    mutable std::unordered_set<eid_t> parents_;
+
+    /*! Flag to mark whether the parents have been computed */
+    mutable bool initialized_{false};
 };
 
 /**
@@ -317,62 +406,27 @@ struct edge_traversal_filter : public filter_visitor {
             return false;
 
         // Now check if the e element is contained in the calculated set
-        return std::any_of(matching_elements_.begin(), matching_elements_.end(),
-            [&e](const auto &te) {
-                std::string tes = te.get().full_name(false);
-                std::string es = e.full_name(false);
-
-                if (tes == es)
-                    return true;
-
-                return false;
-            });
+        return matching_elements_.count(element_ref.value().id()) > 0;
     }
 
 private:
-    template <typename C, typename D>
-    bool add_adjacent(const C &from, const D &to,
-        const std::vector<relationship_t> &relationships) const
-    {
-        bool added_new_element{false};
-
-        for (const auto &from_el : from) {
-            //  Check if any of its relationships of type relationship_
-            //  points to an element already in the matching_elements_
-            //  set
-            for (const auto &rel : from_el.get().relationships()) {
-                // Consider only if connected by one of specified relationships
-                if (util::contains(relationships, rel.type())) {
-                    for (const auto &to_el : to) {
-                        if (rel.destination() ==
-                            detail::destination_comparator(to_el.get())) {
-                            const auto &to_add = forward_ ? to_el : from_el;
-                            if (matching_elements_.insert(to_add).second)
-                                added_new_element = true;
-                        }
-                    }
-                }
-            }
-        }
-
-        return added_new_element;
-    }
-
     void add_parents(const DiagramT &cd) const
     {
-        decltype(matching_elements_) parents;
+        std::unordered_set<eid_t> parents;
 
-        util::for_each(
-            matching_elements_, [&cd, &parents](const auto &element) {
-                auto parent = detail::get<ElementT, DiagramT>(
-                    cd, element.get().path().to_string());
+        for (const auto &element : detail::view<ElementT>(cd)) {
+            if (matching_elements_.count(element.get().id()) == 0)
+                continue;
 
-                while (parent.has_value()) {
-                    parents.emplace(parent.value());
-                    parent = detail::get<ElementT, DiagramT>(
-                        cd, parent.value().path().to_string());
-                }
-            });
+            auto parent = detail::get<ElementT, DiagramT>(
+                cd, element.get().path().to_string());
+
+            while (parent.has_value() &&
+                parents.emplace(parent.value().id()).second) {
+                parent = detail::get<ElementT, DiagramT>(
+                    cd, parent.value().path().to_string());
+            }
+        }
 
         matching_elements_.insert(std::begin(parents), std::end(parents));
     }
@@ -385,6 +439,7 @@ private:
         // First get all elements specified in the filter configuration
         // which will serve as starting points for the search
         // of matching elements
+        std::unordered_set<eid_t> roots;
         for (const auto &root_pattern : roots_) {
             if constexpr (std::is_same_v<ConfigEntryT,
                               common::string_or_regex>) {
@@ -392,30 +447,27 @@ private:
 
                 for (auto &root : root_refs) {
                     if (root.has_value())
-                        matching_elements_.emplace(root.value());
+                        roots.emplace(root.value().id());
                 }
             }
             else {
                 auto root_ref = detail::get<ElementT>(cd, root_pattern);
                 if (root_ref.has_value()) {
-                    matching_elements_.emplace(root_ref.value());
+                    roots.emplace(root_ref.value().id());
                 }
             }
         }
 
-        bool keep_looking{!matching_elements_.empty()};
-        while (keep_looking) {
-            keep_looking = false;
-            if (forward_) {
-                if (add_adjacent(matching_elements_, detail::view<ElementT>(cd),
-                        {relationship_}))
-                    keep_looking = true;
-            }
-            else {
-                if (add_adjacent(detail::view<ElementT>(cd), matching_elements_,
-                        {relationship_}))
-                    keep_looking = true;
-            }
+        // Now find all elements connected to the roots with relationship_
+        // in a single traversal of the relationship graph
+        if (!roots.empty()) {
+            relationship_graph graph;
+            graph.add_elements(detail::view<ElementT>(cd));
+
+            const auto mask = relationship_mask(relationship_);
+
+            matching_elements_ = forward_ ? graph.reachable(roots, mask, 0)
+                                          : graph.reachable(roots, 0, mask);
         }
 
         // For nested diagrams, include also parent elements
@@ -430,7 +482,7 @@ private:
     std::vector<ConfigEntryT> roots_;
     relationship_t relationship_;
     mutable bool initialized_{false};
-    mutable clanguml::common::reference_set<ElementT> matching_elements_;
+    mutable std::unordered_set<eid_t> matching_elements_;
     bool forward_;
 };
 
@@ -492,116 +544,23 @@ struct context_filter : public filter_visitor {
 private:
     void initialize(const diagram &d) const;
 
-    void initialize_effective_context(const diagram &d, unsigned idx) const;
+    void initialize_effective_context(
+        const diagram &d, const relationship_graph &graph, unsigned idx) const;
 
     bool is_inward(relationship_t r) const;
 
     bool is_outward(relationship_t r) const;
 
-    template <typename ElementT>
-    void find_elements_in_direct_relationship(const diagram &d,
-        const config::context_config &context_cfg,
-        std::set<eid_t> &effective_context,
-        std::set<eid_t> &current_iteration_context) const
-    {
-        static_assert(std::is_same_v<ElementT, class_diagram::model::class_> ||
-                std::is_same_v<ElementT, class_diagram::model::enum_> ||
-                std::is_same_v<ElementT, class_diagram::model::concept_>,
-            "ElementT must be either class_ or enum_ or concept_");
-
-        const auto &cd = dynamic_cast<const class_diagram::model::diagram &>(d);
-
-        for (const auto &el : cd.elements<ElementT>()) {
-            // First search all elements of type ElementT in the diagram
-            // which have a relationship to any of the effective_context
-            // elements
-            for (const relationship &rel : el.get().relationships()) {
-                if (!should_include(context_cfg, rel.type()) ||
-                    !d.should_include(rel.type())) {
-                    continue;
-                }
-                // At the moment aggregation and composition are added in the
-                // model in reverse direction, so we don't consider them here
-                if (context_cfg.direction ==
-                        config::context_direction_t::inward &&
-                    (rel.type() == relationship_t::kAggregation ||
-                        rel.type() == relationship_t::kComposition)) {
-                    continue;
-                }
-                if (context_cfg.direction ==
-                        config::context_direction_t::outward &&
-                    (rel.type() != relationship_t::kAggregation &&
-                        rel.type() != relationship_t::kComposition)) {
-                    continue;
-                }
-                for (const auto &element_id : effective_context) {
-                    if (rel.destination() == element_id)
-                        current_iteration_context.emplace(el.get().id());
-                }
-            }
-
-            // Now search current effective_context elements and add any
-            // elements of any type in the diagram which have a relationship
-            // to that element
-            for (const auto element_id : effective_context) {
-                const auto &maybe_element = cd.get(element_id);
-
-                if (!maybe_element)
-                    continue;
-
-                for (const relationship &rel :
-                    maybe_element.value().relationships()) {
-                    if (!should_include(context_cfg, rel.type()) ||
-                        !d.should_include(rel.type())) {
-                        continue;
-                    }
-
-                    if ((context_cfg.direction ==
-                            config::context_direction_t::inward) &&
-                        (rel.type() != relationship_t::kAggregation &&
-                            rel.type() != relationship_t::kComposition)) {
-                        continue;
-                    }
-                    if (context_cfg.direction ==
-                            config::context_direction_t::outward &&
-                        (rel.type() == relationship_t::kAggregation ||
-                            rel.type() == relationship_t::kComposition)) {
-                        continue;
-                    }
-
-                    if (rel.destination() == el.get().id())
-                        current_iteration_context.emplace(el.get().id());
-                }
-            }
-        }
-    }
-
     bool should_include(
         const config::context_config &context_cfg, relationship_t r) const;
 
-    void find_elements_inheritance_relationship(const diagram &d,
-        const config::context_config &context_cfg,
-        std::set<eid_t> &effective_context,
-        std::set<eid_t> &current_iteration_context) const;
-
-    void find_elements_base_classes(const diagram &d,
-        std::set<eid_t> &effective_context,
-        std::set<eid_t> &current_iteration_context,
-        const class_diagram::model::diagram &cd,
-        const std::reference_wrapper<class_diagram::model::class_> &c) const;
-
-    void find_elements_sub_classes(std::set<eid_t> &effective_context,
-        std::set<eid_t> &current_iteration_context,
-        const class_diagram::model::diagram &cd,
-        const std::reference_wrapper<class_diagram::model::class_> &c) const;
-
     std::vector<config::context_config> context_;
 
     /*!
      * Represents all elements which should belong to the diagram based
      * on this filter. It is populated by the initialize() method.
      */
-    mutable std::vector<std::set<eid_t>> effective_contexts_;
+    mutable std::vector<std::unordered_set<eid_t>> effective_contexts_;
 
     /*! Flag to mark whether the filter context has been computed */
     mutable bool initialized_{false};
@@ -610,6 +569,10 @@ private:
 /**
  * Match elements based on their source location, whether it matches to
  * a specified file paths.
+ *
+ * The resolved paths are stored as a sorted array of normalized path
+ * prefixes, so that matching a path requires a single binary search
+ * regardless of the number of configured paths.
  */
 struct paths_filter : public filter_visitor {
     paths_filter(filter_t type, const std::filesystem::path &root,
@@ -624,7 +587,17 @@ struct paths_filter : public filter_visitor {
         const common::model::source_location &sl) const override;
 
 private:
-    std::vector<std::filesystem::path> paths_;
+    /**
+     * @brief Check if absolute path starts with any of the filter paths
+     *
+     * @param p Absolute path
+     * @return True, if any of the filter paths is a prefix of `p`
+     */
+    bool matches(const std::filesystem::path &p) const;
+
+    /*! Sorted normalized path prefixes, none of which is a prefix of
+        another */
+    std::vector<std::string> prefixes_;
     std::filesystem::path root_;
 };
 
@@ -58,7 +58,11 @@ public:
      *
      * @param ns Namespace.
      */
-    void set_namespace(const namespace_ &ns) { ns_ = ns; }
+    void set_namespace(const namespace_ &ns)
+    {
+        ns_ = ns;
+        invalidate_full_name_cache();
+    }
 
     /**
      * Return elements namespace.
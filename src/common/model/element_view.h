@@ -19,6 +19,8 @@
 
 #include "common/types.h"
 
+#include <unordered_map>
+
 namespace clanguml::common::model {
 
 using clanguml::common::eid_t;
@@ -26,6 +28,11 @@ using clanguml::common::eid_t;
 /**
  * Provides type based views over elements in a diagram.
  *
+ * Besides the list of elements in the order they were added, the view keeps
+ * an index of elements by their id, so that lookups by id do not require
+ * a linear search. Element id's must not change and elements must not be
+ * removed after the element has been added to the view.
+ *
  * @tparam T Type of diagram element
  */
 template <typename T> class element_view {
@@ -37,9 +44,36 @@ public:
      */
     void add(std::reference_wrapper<T> element)
     {
+        // If more elements have the same id, the first one is returned
+        // by get()
+        elements_by_id_.try_emplace(element.get().id(), elements_.size());
         elements_.emplace_back(std::move(element));
     }
 
+    /**
+     * @brief Replace reference to diagram element with another element
+     *
+     * The replacement takes the position of the replaced element in the view.
+     *
+     * @param existing Diagram element in the view
+     * @param replacement Diagram element with the same id
+     */
+    void replace(const T &existing, T &replacement)
+    {
+        if (auto it = elements_by_id_.find(existing.id());
+            it != elements_by_id_.end() &&
+            &elements_[it->second].get() == &existing) {
+            elements_[it->second] = std::ref(replacement);
+            return;
+        }
+
+        // Only the first element with a given id is indexed
+        for (auto &e : elements_) {
+            if (&e.get() == &existing)
+                e = std::ref(replacement);
+        }
+    }
+
     /**
      * @brief Get collection of reference to diagram elements
      *
@@ -62,15 +96,21 @@ public:
      */
     common::optional_ref<T> get(eid_t id) const
     {
-        for (const auto &e : elements_) {
-            if (e.get().id() == id) {
-                return {e};
-            }
-        }
+        auto it = elements_by_id_.find(id);
+        if (it == elements_by_id_.end())
+            return {};
 
-        return {};
+        return {elements_[it->second]};
     }
 
+    /**
+     * @brief Check whether the view contains an element with a given id
+     *
+     * @param id Global id of a diagram element
+     * @return True, if the view contains the element
+     */
+    bool contains(eid_t id) const { return elements_by_id_.count(id) > 0; }
+
     /**
      * @brief Check whether the element view is empty
      *
@@ -80,6 +120,8 @@ public:
 
 private:
     reference_vector<T> elements_;
+    // Positions of elements in `elements_` by their id
+    std::unordered_map<eid_t, size_t> elements_by_id_;
 };
 
 } // namespace clanguml::common::model
\ No newline at end of file
@@ -22,6 +22,7 @@
 #include <iostream>
 #include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace clanguml::common::model {
@@ -32,6 +33,11 @@ namespace clanguml::common::model {
  * This class provides a common trait for diagram elements which can contain
  * other nested elements, e.g. packages.
  *
+ * Nested elements are stored in the order in which they were added, and
+ * additionally indexed by their name, so that adding and finding elements
+ * does not require a linear search at each nested level. Names of the
+ * elements must not change after they have been added.
+ *
  * @embed{nested_trait_hierarchy_class.svg}
  *
  * @tparam T Type of element
@@ -59,15 +65,12 @@ public:
     template <typename V = T>
     [[nodiscard]] bool add_element(std::unique_ptr<V> p)
     {
-        auto it = std::find_if(elements_.begin(), elements_.end(),
-            [&p](const auto &e) { return *e == *p; });
-
-        if (it != elements_.end()) {
+        if (find_equal(*p).has_value()) {
             // Element already in element tree
             return false;
         }
 
-        elements_.emplace_back(std::move(p));
+        append_element(std::move(p));
 
         return true;
     }
@@ -106,6 +109,61 @@ public:
             "No parent element found for " + path.to_string());
     }
 
+    /**
+     * Move elements from another nested element into this one.
+     *
+     * Elements which do not exist yet at the current nested level are moved
+     * together with their nested elements and appended in their original
+     * order. For elements which already exist, `on_duplicate` is called with
+     * the existing element and its duplicate. If it returns true, the
+     * existing element is replaced with its duplicate, otherwise if both are
+     * nested elements, their children are merged recursively.
+     *
+     * @tparam OnMoved Functor type
+     * @tparam OnDuplicate Functor type
+     * @param other Nested element to move the elements from
+     * @param on_moved Called for each moved element, including nested ones
+     * @param on_duplicate Called for each element which already exists,
+     *                     returns true if the duplicate should replace it
+     */
+    template <typename OnMoved, typename OnDuplicate>
+    void merge_elements(nested_trait<T, Path> &other, OnMoved &&on_moved,
+        OnDuplicate &&on_duplicate)
+    {
+        for (auto &e : other.elements_) {
+            const auto existing_index = find_equal(*e);
+
+            if (!existing_index) {
+                for_each_nested_element(*e, on_moved);
+                append_element(std::move(e));
+                continue;
+            }
+
+            auto &existing = elements_[*existing_index];
+
+            if (on_duplicate(*existing, *e)) {
+                // The replacement takes the position of the existing
+                // element, which is left in `other`
+                existing.swap(e);
+                continue;
+            }
+
+            auto *existing_nested =
+                dynamic_cast<nested_trait<T, Path> *>(existing.get());
+            auto *other_nested = dynamic_cast<nested_trait<T, Path> *>(e.get());
+
+            if (existing_nested != nullptr && other_nested != nullptr)
+                existing_nested->merge_elements(
+                    *other_nested, on_moved, on_duplicate);
+        }
+
+        util::erase_if(other.elements_, [](const auto &e) { return !e; });
+
+        other.elements_by_name_.clear();
+        for (auto i = 0U; i < other.elements_.size(); i++)
+            other.elements_by_name_[other.elements_[i]->name()].push_back(i);
+    }
+
     /**
      * Get element at path, if exists.
      *
@@ -147,16 +205,18 @@ public:
     {
         assert(!util::contains(name, "::"));
 
-        auto it = std::find_if(elements_.cbegin(), elements_.cend(),
-            [&](const auto &p) { return name == p->name(); });
+        auto it = elements_by_name_.find(name);
 
-        if (it == elements_.end())
+        if (it == elements_by_name_.end())
             return optional_ref<V>{};
 
-        assert(it->get() != nullptr);
+        // Return the first element added with this name
+        auto *e = elements_[it->second.front()].get();
+
+        assert(e != nullptr);
 
-        if (dynamic_cast<V *>(it->get()))
-            return optional_ref<V>{std::ref<V>(dynamic_cast<V &>(*it->get()))};
+        if (dynamic_cast<V *>(e))
+            return optional_ref<V>{std::ref<V>(dynamic_cast<V &>(*e))};
 
         return optional_ref<V>{};
     }
@@ -170,9 +230,7 @@ public:
      */
     bool has_element(const std::string &name) const
     {
-        return std::find_if(elements_.cbegin(), elements_.cend(),
-                   [&](const auto &p) { return name == p->name(); }) !=
-            elements_.end();
+        return elements_by_name_.count(name) > 0;
     }
 
     /**
@@ -246,7 +304,50 @@ public:
     }
 
 private:
+    /**
+     * Find an element equal to `p` at the current nested level.
+     *
+     * Equal elements always have the same name, so only elements with
+     * the name of `p` have to be compared.
+     *
+     * @return Position of the equal element in `elements_`, if any
+     */
+    template <typename V>
+    std::optional<size_t> find_equal(const V &p) const
+    {
+        auto it = elements_by_name_.find(p.name());
+
+        if (it == elements_by_name_.end())
+            return {};
+
+        for (const auto i : it->second) {
+            if (*elements_[i] == p)
+                return i;
+        }
+
+        return {};
+    }
+
+    template <typename V> void append_element(std::unique_ptr<V> p)
+    {
+        elements_by_name_[p->name()].push_back(elements_.size());
+        elements_.emplace_back(std::move(p));
+    }
+
+    template <typename F> static void for_each_nested_element(T &e, F &f)
+    {
+        f(e);
+
+        if (auto *nested = dynamic_cast<nested_trait<T, Path> *>(&e);
+            nested != nullptr) {
+            for (auto &child : nested->elements_)
+                for_each_nested_element(*child, f);
+        }
+    }
+
     std::vector<std::unique_ptr<T>> elements_;
+    // Positions of elements in `elements_` by their name
+    std::unordered_map<std::string, std::vector<size_t>> elements_by_name_;
 };
 
 } // namespace clanguml::common::model
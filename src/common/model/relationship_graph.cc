@@ -0,0 +1,92 @@
+/**
+ * @file src/common/model/relationship_graph.cc
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "relationship_graph.h"
+
+namespace clanguml::common::model {
+
+relationship_mask_t relationship_mask(
+    const std::vector<relationship_t> &relationships)
+{
+    relationship_mask_t result{0};
+
+    for (const auto r : relationships)
+        result |= relationship_mask(r);
+
+    return result;
+}
+
+void relationship_graph::add_node(eid_t id) { nodes_.emplace(id); }
+
+bool relationship_graph::has_node(eid_t id) const
+{
+    return nodes_.count(id) > 0;
+}
+
+void relationship_graph::add_edge(eid_t from, eid_t to, relationship_t r)
+{
+    outgoing_[from].push_back({to, r});
+    incoming_[to].push_back({from, r});
+}
+
+void relationship_graph::adjacent(eid_t id, relationship_mask_t mask,
+    direction_t direction, std::unordered_set<eid_t> &result) const
+{
+    const auto &edges =
+        direction == direction_t::kOutgoing ? outgoing_ : incoming_;
+
+    auto it = edges.find(id);
+    if (it == edges.end())
+        return;
+
+    for (const auto &e : it->second) {
+        if ((relationship_mask(e.type) & mask) != 0 && has_node(e.node))
+            result.emplace(e.node);
+    }
+}
+
+std::unordered_set<eid_t> relationship_graph::reachable(
+    const std::unordered_set<eid_t> &roots, relationship_mask_t outgoing_mask,
+    relationship_mask_t incoming_mask, std::optional<unsigned> max_depth) const
+{
+    std::unordered_set<eid_t> result{roots};
+    std::unordered_set<eid_t> frontier{roots};
+    std::unordered_set<eid_t> next;
+
+    for (auto depth = 0U;
+         !frontier.empty() && (!max_depth || depth < *max_depth); depth++) {
+        next.clear();
+
+        for (const auto id : frontier) {
+            if (outgoing_mask != 0)
+                adjacent(id, outgoing_mask, direction_t::kOutgoing, next);
+            if (incoming_mask != 0)
+                adjacent(id, incoming_mask, direction_t::kIncoming, next);
+        }
+
+        frontier.clear();
+        for (const auto id : next) {
+            if (result.emplace(id).second)
+                frontier.emplace(id);
+        }
+    }
+
+    return result;
+}
+
+} // namespace clanguml::common::model
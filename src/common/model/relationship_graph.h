@@ -0,0 +1,169 @@
+/**
+ * @file src/common/model/relationship_graph.h
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "common/model/enums.h"
+#include "common/types.h"
+
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace clanguml::common::model {
+
+using clanguml::common::eid_t;
+
+/**
+ * @brief Bitmask of relationship types
+ */
+using relationship_mask_t = std::uint32_t;
+
+/**
+ * @brief Get mask of a single relationship type
+ *
+ * @param r Relationship type
+ * @return Relationship mask
+ */
+constexpr relationship_mask_t relationship_mask(relationship_t r)
+{
+    return relationship_mask_t{1} << static_cast<unsigned>(r);
+}
+
+/**
+ * @brief Get mask of a list of relationship types
+ *
+ * @param relationships List of relationship types
+ * @return Relationship mask
+ */
+relationship_mask_t relationship_mask(
+    const std::vector<relationship_t> &relationships);
+
+/**
+ * @brief Adjacency index of relationships between diagram elements
+ *
+ * The graph stores for each diagram element both its outgoing and incoming
+ * relationships, so that elements in relationship with a set of elements can
+ * be found in a single breadth-first traversal, instead of repeatedly scanning
+ * all relationships of all elements in the diagram.
+ *
+ * The graph is meant to be built once the diagram model is complete.
+ */
+class relationship_graph {
+public:
+    /**
+     * @brief Direction in which edges are followed during traversal
+     */
+    enum class direction_t {
+        kOutgoing, /*!< From relationship source to its destination */
+        kIncoming  /*!< From relationship destination to its source */
+    };
+
+    /**
+     * @brief Add element and all its relationships to the graph
+     *
+     * @tparam ElementT Diagram element type
+     * @param e Diagram element
+     */
+    template <typename ElementT> void add_element(const ElementT &e)
+    {
+        add_node(e.id());
+
+        for (const auto &rel : e.relationships())
+            add_edge(e.id(), rel.destination(), rel.type());
+    }
+
+    /**
+     * @brief Add all elements from a view to the graph
+     *
+     * @tparam ElementsT Range of element references
+     * @param elements Diagram elements
+     */
+    template <typename ElementsT> void add_elements(const ElementsT &elements)
+    {
+        for (const auto &e : elements)
+            add_element(e.get());
+    }
+
+    /**
+     * @brief Add node to the graph
+     *
+     * Only nodes are returned by the traversal methods, edges pointing to
+     * ids, which are not nodes in the graph are ignored.
+     *
+     * @param id Element id
+     */
+    void add_node(eid_t id);
+
+    /**
+     * @brief Check if element is a node in the graph
+     *
+     * @param id Element id
+     * @return True, if the element has been added to the graph
+     */
+    bool has_node(eid_t id) const;
+
+    /**
+     * @brief Add relationship edge to the graph
+     *
+     * @param from Id of relationship source
+     * @param to Id of relationship destination
+     * @param r Relationship type
+     */
+    void add_edge(eid_t from, eid_t to, relationship_t r);
+
+    /**
+     * @brief Add nodes adjacent to `id` to `result`
+     *
+     * @param id Element id
+     * @param mask Relationship types to follow
+     * @param direction Direction of the edges to follow
+     * @param result Set of adjacent nodes
+     */
+    void adjacent(eid_t id, relationship_mask_t mask, direction_t direction,
+        std::unordered_set<eid_t> &result) const;
+
+    /**
+     * @brief Find all nodes reachable from a set of root nodes
+     *
+     * At each step, both outgoing edges matching `outgoing_mask` and
+     * incoming edges matching `incoming_mask` are followed.
+     *
+     * @param roots Ids of the starting elements, included in the result
+     * @param outgoing_mask Relationship types to follow to destinations
+     * @param incoming_mask Relationship types to follow to sources
+     * @param max_depth Maximum number of edges to follow from roots
+     * @return Set of reachable nodes
+     */
+    std::unordered_set<eid_t> reachable(const std::unordered_set<eid_t> &roots,
+        relationship_mask_t outgoing_mask, relationship_mask_t incoming_mask,
+        std::optional<unsigned> max_depth = {}) const;
+
+private:
+    struct edge {
+        eid_t node;
+        relationship_t type;
+    };
+
+    std::unordered_set<eid_t> nodes_;
+    std::unordered_map<eid_t, std::vector<edge>> outgoing_;
+    std::unordered_map<eid_t, std::vector<edge>> incoming_;
+};
+
+} // namespace clanguml::common::model
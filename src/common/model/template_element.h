@@ -71,6 +71,12 @@ public:
      */
     void template_specialization_found(bool found);
 
+protected:
+    void on_template_params_changed() override
+    {
+        invalidate_full_name_cache();
+    }
+
 private:
     bool template_specialization_found_{false};
     bool is_template_{false};
@@ -42,6 +42,8 @@ std::ostream &template_trait::render_template_params(std::ostream &ostr,
 void template_trait::add_template(template_parameter &&tmplt)
 {
     templates_.push_back(std::move(tmplt));
+
+    on_template_params_changed();
 }
 
 const std::vector<template_parameter> &template_trait::template_params() const
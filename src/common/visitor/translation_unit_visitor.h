@@ -33,6 +33,7 @@
 #include <clang/AST/RawCommentList.h>
 #include <clang/Basic/Module.h>
 #include <clang/Basic/SourceManager.h>
+#include <llvm/ADT/DenseMap.h>
 
 #include <deque>
 #include <functional>
@@ -105,6 +106,24 @@ public:
      */
     common::visitor::ast_id_mapper &id_mapper() const { return id_mapper_; }
 
+    /**
+     * @brief Finalize the diagram model once all translation units have
+     *        been visited
+     *
+     * Processing which requires access to the translation unit should be
+     * done in the visitors `finalize()` method, which is called after each
+     * translation unit. Any processing of the entire diagram model should be
+     * done here instead, as it is called only once per diagram. Visitors
+     * can hide this method with their own implementation.
+     *
+     * @param diagram Reference to the diagram model
+     * @param config Reference to the diagram configuration
+     */
+    static void finalize_diagram(
+        DiagramT & /*diagram*/, const ConfigT & /*config*/)
+    {
+    }
+
     /**
      * @brief Get clang::SourceManager
      * @return Reference to @ref clang::SourceManager used by this translation
@@ -296,7 +315,7 @@ public:
      * @param decl Clang declaration.
      * @return True, if the entity should be included in the diagram.
      */
-    bool should_include(const clang::NamedDecl *decl)
+    bool should_include(const clang::NamedDecl *decl) const
     {
         if (decl == nullptr)
             return false;
@@ -305,16 +324,62 @@ public:
                 decl->getSourceRange().getBegin()))
             return false;
 
-        auto should_include_namespace = diagram().should_include(
+        return should_include_namespace(decl) &&
+            should_include_file(decl->getLocation());
+    }
+
+    /**
+     * @brief Check if the diagram should include the namespace of a
+     *        declaration.
+     *
+     * The result is cached for each canonical declaration in the
+     * translation unit, as all its redeclarations have the same qualified
+     * name.
+     *
+     * @param decl Clang declaration.
+     * @return True, if the namespace should be included in the diagram.
+     */
+    bool should_include_namespace(const clang::NamedDecl *decl) const
+    {
+        const auto *canonical_decl = decl->getCanonicalDecl();
+
+        if (auto it = namespace_verdicts_.find(canonical_decl);
+            it != namespace_verdicts_.end())
+            return it->second;
+
+        const auto result = diagram().should_include(
             common::model::namespace_{decl->getQualifiedNameAsString()});
 
-        const auto decl_file =
-            decl->getLocation().printToString(source_manager());
+        namespace_verdicts_.emplace(canonical_decl, result);
+
+        return result;
+    }
+
+    /**
+     * @brief Check if the diagram should include the file of a source
+     *        location.
+     *
+     * The result is cached for each file in the translation unit, so it
+     * can only be used when file filters do not depend on the diagram
+     * contents (i.e. not in include diagrams).
+     *
+     * @param location Clang source location.
+     * @return True, if the file should be included in the diagram.
+     */
+    bool should_include_file(clang::SourceLocation location) const
+    {
+        const auto &sm = source_manager();
+        const auto file_id = sm.getFileID(sm.getExpansionLoc(location));
+
+        if (auto it = file_verdicts_.find(file_id); it != file_verdicts_.end())
+            return it->second;
+
+        const auto result = diagram().should_include(
+            common::model::source_file{location.printToString(sm)});
 
-        const auto should_include_decl_file =
-            diagram().should_include(common::model::source_file{decl_file});
+        file_verdicts_.emplace(file_id, result);
 
-        return should_include_namespace && should_include_decl_file;
+        return result;
     }
 
     /**
@@ -362,5 +427,9 @@ private:
     std::set<const clang::RawComment *> processed_comments_;
 
     mutable common::visitor::ast_id_mapper id_mapper_;
+
+    // Filter verdicts cached for the current translation unit
+    mutable llvm::DenseMap<const clang::Decl *, bool> namespace_verdicts_;
+    mutable llvm::DenseMap<clang::FileID, bool> file_verdicts_;
 };
 } // namespace clanguml::common::visitor
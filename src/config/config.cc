@@ -258,26 +258,14 @@ void inheritable_diagram_options::inherit(
     generate_metadata.override(parent.generate_metadata);
     allow_empty_diagrams.override(parent.allow_empty_diagrams);
     type_aliases.override(parent.type_aliases);
+
+    type_alias_matcher_.reset();
 }
 
 std::string inheritable_diagram_options::simplify_template_type(
     std::string full_name) const
 {
-    type_aliases_longer_first_t aliases;
-    aliases.insert(type_aliases().begin(), type_aliases().end());
-
-    bool matched{true};
-    while (matched) {
-        auto matched_in_iteration{false};
-        for (const auto &[pattern, replacement] : aliases) {
-            matched_in_iteration =
-                util::replace_all(full_name, pattern, replacement) ||
-                matched_in_iteration;
-        }
-        matched = matched_in_iteration;
-    }
-
-    return full_name;
+    return type_alias_matcher_.get(type_aliases()).simplify(full_name);
 }
 
 bool inheritable_diagram_options::generate_fully_qualified_name() const
@@ -410,6 +398,8 @@ void diagram::initialize_type_aliases()
         type_aliases().insert({"std::basic_string", "std::string"});
     }
 #endif
+
+    type_alias_matcher_.reset();
 }
 
 common::model::diagram_t class_diagram::type() const
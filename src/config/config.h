@@ -20,6 +20,7 @@
 #include "common/model/enums.h"
 #include "common/types.h"
 #include "option.h"
+#include "type_alias_matcher.h"
 #include "util/util.h"
 
 #include <spdlog/spdlog.h>
@@ -479,18 +480,6 @@ using relationship_hints_t = std::map<std::string, relationship_hint_t>;
 
 using type_aliases_t = std::map<std::string, std::string>;
 
-struct type_aliases_longer_first_comparator {
-    bool operator()(const std::string &a, const std::string &b) const
-    {
-        if (a.size() == b.size())
-            return a > b;
-
-        return a.size() > b.size();
-    }
-};
-using type_aliases_longer_first_t =
-    std::map<std::string, std::string, type_aliases_longer_first_comparator>;
-
 enum class location_t { marker, fileline, function };
 
 std::string to_string(location_t cp);
@@ -597,6 +586,10 @@ protected:
     // @see config::diagram::root_directory()
     option<std::filesystem::path> relative_to{"relative_to"};
 
+    // Type aliases compiled on first call to simplify_template_type(),
+    // must be reset whenever `type_aliases` change
+    type_alias_matcher_cache type_alias_matcher_;
+
     friend YAML::Emitter &operator<<(
         YAML::Emitter &out, const inheritable_diagram_options &c);
 };
@@ -686,6 +679,8 @@ struct sequence_diagram : public diagram {
         option_with_alt_names_tag{}, "from", {"start_from"}};
     option<std::vector<std::vector<source_location>>> from_to{"from_to"};
     option<std::vector<source_location>> to{"to"};
+    option<unsigned> message_chain_max_depth{"message_chain_max_depth", 0};
+    option<unsigned> message_chain_max_count{"message_chain_max_count", 0};
 };
 
 /**
@@ -246,6 +246,8 @@ types:
         from: !optional [source_location_t]
         from_to: !optional [[source_location_t]]
         to: !optional [source_location_t]
+        message_chain_max_depth: !optional int
+        message_chain_max_count: !optional int
     package_diagram_t:
         type: !variant [package]
         #
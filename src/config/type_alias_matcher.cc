@@ -0,0 +1,151 @@
+/**
+ * @file src/config/type_alias_matcher.cc
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "type_alias_matcher.h"
+
+#include "util/util.h"
+
+#include <algorithm>
+
+namespace clanguml::config {
+
+type_alias_matcher::type_alias_matcher(
+    const std::map<std::string, std::string> &aliases,
+    std::size_t max_cache_size)
+    : nodes_(1)
+    , max_cache_size_{max_cache_size}
+{
+    for (const auto &[pattern, replacement] : aliases) {
+        if (pattern.empty())
+            continue;
+
+        aliases_.emplace_back(pattern, replacement);
+
+        std::size_t current{0};
+        for (const auto c : pattern) {
+            auto it = nodes_[current].children.find(c);
+            if (it == nodes_[current].children.end()) {
+                nodes_.emplace_back();
+                it = nodes_[current]
+                         .children.emplace(c, nodes_.size() - 1)
+                         .first;
+            }
+            current = it->second;
+        }
+
+        nodes_[current].is_pattern = true;
+    }
+
+    std::sort(aliases_.begin(), aliases_.end(),
+        [](const auto &a, const auto &b) {
+            if (a.first.size() == b.first.size())
+                return a.first > b.first;
+
+            return a.first.size() > b.first.size();
+        });
+}
+
+std::string type_alias_matcher::simplify(const std::string &full_name) const
+{
+    if (aliases_.empty() || !matches_any(full_name))
+        return full_name;
+
+    {
+        std::shared_lock<std::shared_mutex> l(cache_mutex_);
+        if (auto it = cache_.find(full_name); it != cache_.end())
+            return it->second;
+    }
+
+    std::string result{full_name};
+
+    bool matched{true};
+    while (matched) {
+        matched = false;
+        for (const auto &[pattern, replacement] : aliases_) {
+            matched = util::replace_all(result, pattern, replacement) ||
+                matched;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> l(cache_mutex_);
+    if (cache_.size() >= max_cache_size_)
+        cache_.clear();
+    cache_.emplace(full_name, result);
+
+    return result;
+}
+
+std::size_t type_alias_matcher::cache_size() const
+{
+    std::shared_lock<std::shared_mutex> l(cache_mutex_);
+
+    return cache_.size();
+}
+
+bool type_alias_matcher::matches_any(const std::string &input) const
+{
+    for (auto pos = 0U; pos < input.size(); pos++) {
+        std::size_t current{0};
+        for (auto i = pos; i < input.size(); i++) {
+            const auto it = nodes_[current].children.find(input[i]);
+            if (it == nodes_[current].children.end())
+                break;
+
+            current = it->second;
+            if (nodes_[current].is_pattern)
+                return true;
+        }
+    }
+
+    return false;
+}
+
+type_alias_matcher_cache &type_alias_matcher_cache::operator=(
+    const type_alias_matcher_cache & /*other*/)
+{
+    reset();
+
+    return *this;
+}
+
+const type_alias_matcher &type_alias_matcher_cache::get(
+    const std::map<std::string, std::string> &aliases) const
+{
+    if (const auto *matcher = matcher_.load(std::memory_order_acquire);
+        matcher != nullptr)
+        return *matcher;
+
+    std::lock_guard<std::mutex> l(mutex_);
+
+    if (!owner_) {
+        owner_ = std::make_unique<type_alias_matcher>(aliases);
+        matcher_.store(owner_.get(), std::memory_order_release);
+    }
+
+    return *owner_;
+}
+
+void type_alias_matcher_cache::reset()
+{
+    std::lock_guard<std::mutex> l(mutex_);
+
+    matcher_.store(nullptr, std::memory_order_release);
+    owner_.reset();
+}
+
+} // namespace clanguml::config
@@ -0,0 +1,131 @@
+/**
+ * @file src/config/type_alias_matcher.h
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace clanguml::config {
+
+/**
+ * @brief Replaces type aliases in type names
+ *
+ * Patterns are replaced in the order of decreasing length (and reverse
+ * lexicographical order for patterns of equal length), each pattern in the
+ * entire type name before the next one, until no pattern matches. The
+ * order matters for overlapping patterns, e.g. with aliases `ab` -> `X`
+ * and `bcd` -> `Y`, `abcd` becomes `aY`.
+ *
+ * All patterns are also compiled into a prefix trie, which allows checking
+ * in a single pass, whether any pattern matches a type name at all, as
+ * most type names do not contain any alias. Results are memoized, as the
+ * same types are simplified many times.
+ *
+ * This class is thread-safe.
+ */
+class type_alias_matcher {
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param aliases Map of type name patterns to their aliases
+     * @param max_cache_size Maximum number of memoized results, after which
+     *                       the memoized results are discarded
+     */
+    explicit type_alias_matcher(
+        const std::map<std::string, std::string> &aliases,
+        std::size_t max_cache_size = 64 * 1024);
+
+    /**
+     * @brief Replace all type aliases in a type name
+     *
+     * @param full_name Type name
+     * @return Simplified type name
+     */
+    std::string simplify(const std::string &full_name) const;
+
+    /**
+     * @brief Get the number of memoized results
+     *
+     * @return Number of memoized results
+     */
+    std::size_t cache_size() const;
+
+private:
+    struct node {
+        std::unordered_map<char, std::size_t> children;
+        bool is_pattern{false};
+    };
+
+    bool matches_any(const std::string &input) const;
+
+    std::vector<node> nodes_;
+    // Patterns and their replacements in the order of replacing
+    std::vector<std::pair<std::string, std::string>> aliases_;
+
+    const std::size_t max_cache_size_;
+    mutable std::shared_mutex cache_mutex_;
+    mutable std::unordered_map<std::string, std::string> cache_;
+};
+
+/**
+ * @brief Lazily built type_alias_matcher of a diagram config
+ *
+ * The matcher is built on first use. Copies of the config do not share the
+ * matcher, as their type aliases can differ.
+ */
+class type_alias_matcher_cache {
+public:
+    type_alias_matcher_cache() = default;
+
+    type_alias_matcher_cache(const type_alias_matcher_cache & /*other*/) { }
+
+    type_alias_matcher_cache &operator=(
+        const type_alias_matcher_cache & /*other*/);
+
+    /**
+     * @brief Get the matcher, building it from `aliases` if necessary
+     *
+     * @param aliases Map of type name patterns to their aliases
+     * @return Reference to the matcher
+     */
+    const type_alias_matcher &get(
+        const std::map<std::string, std::string> &aliases) const;
+
+    /**
+     * @brief Discard the matcher, e.g. after the type aliases have changed
+     */
+    void reset();
+
+private:
+    mutable std::mutex mutex_;
+    mutable std::unique_ptr<const type_alias_matcher> owner_;
+    // Allows reading the matcher without locking the mutex, once it is built
+    mutable std::atomic<const type_alias_matcher *> matcher_{nullptr};
+};
+
+} // namespace clanguml::config
@@ -387,6 +387,8 @@ YAML::Emitter &operator<<(YAML::Emitter &out, const sequence_diagram &c)
     out << c.from;
     out << c.from_to;
     out << c.to;
+    out << c.message_chain_max_depth;
+    out << c.message_chain_max_count;
     out << dynamic_cast<const inheritable_diagram_options &>(c);
     out << YAML::EndMap;
     return out;
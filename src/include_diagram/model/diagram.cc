@@ -133,6 +133,34 @@ inja::json diagram::context() const
     return ctx;
 }
 
+void diagram::merge(diagram &&other)
+{
+    std::unordered_set<const source_file *> moved;
+
+    merge_elements(
+        other, [&moved](const source_file &f) { moved.emplace(&f); },
+        [](source_file &existing, source_file &duplicate) {
+            // Source file properties are updated on each include directive,
+            // so the values from the later translation units take precedence
+            existing.set_type(duplicate.type());
+            existing.set_file(duplicate.file());
+            if (!duplicate.file_relative().empty())
+                existing.set_file_relative(duplicate.file_relative());
+            existing.set_line(duplicate.line());
+            existing.set_system_header(duplicate.is_system_header());
+
+            for (auto &r : duplicate.relationships())
+                existing.add_relationship(std::move(r));
+
+            return false;
+        });
+
+    for (const auto &f : other.files()) {
+        if (moved.count(&f.get()) > 0)
+            element_view<source_file>::add(f);
+    }
+}
+
 bool diagram::is_empty() const { return element_view<source_file>::is_empty(); }
 
 } // namespace clanguml::include_diagram::model
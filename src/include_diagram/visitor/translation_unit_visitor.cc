@@ -71,10 +71,10 @@ void translation_unit_visitor::include_visitor::InclusionDirective(
     using common::model::source_file;
     using common::model::source_file_t;
 
-    auto current_file =
-        std::filesystem::path{source_manager().getFilename(hash_loc).str()};
-    current_file = std::filesystem::absolute(current_file);
-    current_file = current_file.lexically_normal();
+    const auto &current_file =
+        util::normalize_path(source_manager().getFilename(hash_loc).str(),
+            config().root_directory())
+            .absolute;
 
     auto current_file_id = process_source_file(current_file);
     if (!current_file_id)
@@ -97,9 +97,6 @@ void translation_unit_visitor::include_visitor::InclusionDirective(
     LOG_DBG("Processing include directive {} in file {}", include_path.string(),
         current_file.string());
 
-    auto relative_include_path =
-        std::filesystem::relative(include_path, config().root_directory());
-
     if (diagram().should_include(source_file{include_path})) {
         process_internal_header(include_path,
             file_type != clang::SrcMgr::CharacteristicKind::C_User,
@@ -119,13 +116,14 @@ void translation_unit_visitor::include_visitor::process_internal_header(
     const eid_t current_file_id)
 {
     // Make the path relative with respect to relative_to config option
-    auto relative_include_path =
-        std::filesystem::relative(include_path, config().root_directory());
+    const auto &normalized_include_path =
+        util::normalize_path(include_path, config().root_directory());
 
     // Check if this source file is already registered in the diagram,
     // if not add it
     auto diagram_path =
-        common::model::source_file{relative_include_path}.full_path();
+        common::model::source_file{normalized_include_path.relative}
+            .full_path();
     if (!diagram().get_element(diagram_path.to_string()).has_value()) {
         diagram().add_file(std::make_unique<common::model::source_file>(
             diagram_path.to_string()));
@@ -134,8 +132,7 @@ void translation_unit_visitor::include_visitor::process_internal_header(
     auto &include_file = diagram().get_element(diagram_path).value();
 
     include_file.set_type(common::model::source_file_t::kHeader);
-    include_file.set_file(
-        std::filesystem::absolute(include_path).lexically_normal().string());
+    include_file.set_file(normalized_include_path.absolute.string());
     include_file.set_line(0);
     include_file.set_system_header(is_system);
 
@@ -202,8 +199,9 @@ translation_unit_visitor::include_visitor::process_source_file(
         LOG_DBG("Processing source file {}", file.string());
 
         // Relativize the path with respect to effective root directory
-        auto relative_file_path =
-            std::filesystem::relative(file_path, config().root_directory());
+        const auto &normalized_file_path =
+            util::normalize_path(file_path, config().root_directory());
+        const auto &relative_file_path = normalized_file_path.relative;
 
         [[maybe_unused]] const auto relative_file_path_str =
             relative_file_path.string();
@@ -227,14 +225,11 @@ translation_unit_visitor::include_visitor::process_source_file(
         else
             source_file.set_type(source_file_t::kHeader);
 
-        source_file.set_file(std::filesystem::absolute(file.string())
-                                 .lexically_normal()
-                                 .string());
+        source_file.set_file(normalized_file_path.absolute.string());
 
-        if (util::is_relative_to(file_path, config().root_directory())) {
-            source_file.set_file_relative(util::path_to_url(
-                relative(source_file.file(), config().root_directory())
-                    .string()));
+        if (normalized_file_path.is_relative_to_root) {
+            source_file.set_file_relative(
+                util::path_to_url(relative_file_path.string()));
         }
         else {
             source_file.set_file_relative("");
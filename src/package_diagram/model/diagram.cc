@@ -74,6 +74,27 @@ inja::json diagram::context() const
     return ctx;
 }
 
+void diagram::merge(diagram &&other)
+{
+    std::unordered_set<const common::model::element *> moved;
+
+    merge_elements(
+        other,
+        [&moved](const common::model::element &e) { moved.emplace(&e); },
+        [](common::model::element &existing,
+            common::model::element &duplicate) {
+            for (auto &r : duplicate.relationships())
+                existing.add_relationship(std::move(r));
+
+            return false;
+        });
+
+    for (const auto &p : other.packages()) {
+        if (moved.count(&p.get()) > 0)
+            element_view<package>::add(p);
+    }
+}
+
 bool diagram::is_empty() const { return element_view<package>::is_empty(); }
 } // namespace clanguml::package_diagram::model
 
@@ -22,6 +22,7 @@
 #include "common/model/package.h"
 
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 namespace clanguml::package_diagram::model {
@@ -158,6 +159,18 @@ public:
      */
     inja::json context() const override;
 
+    /**
+     * @brief Merge elements from another partial diagram model.
+     *
+     * This method is used to combine diagram models built from separate
+     * subsets of translation units. New elements are appended in their
+     * original order, while relationships of duplicate elements are added
+     * to the elements already in the model.
+     *
+     * @param other Diagram model to merge into this diagram
+     */
+    void merge(diagram &&other);
+
     /**
      * @brief Check whether the diagram is empty
      *
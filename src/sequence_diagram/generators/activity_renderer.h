@@ -0,0 +1,333 @@
+/**
+ * @file src/sequence_diagram/generators/activity_renderer.h
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "common/types.h"
+
+#include <algorithm>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace clanguml::sequence_diagram::generators {
+
+using clanguml::common::eid_t;
+
+/**
+ * @brief Call stack of activities in sequence diagram generators
+ *
+ * Sequence diagram generators expand activities recursively, starting from
+ * the activity specified in the `from` condition, and expand each callee
+ * activity every time it is called, unless the callee is already on the
+ * call stack (i.e. the call is recursive).
+ *
+ * This class keeps track of the call stack and of what the output of each
+ * activity being rendered depends on, so that derived classes can memoize
+ * the rendered output of activities called from many places. The output of
+ * an activity can be reused only when rendering it again would give the
+ * same result, i.e.:
+ *  - rendering did not depend on generator state, e.g. it did not generate
+ *    new participants or messages in static declaration context,
+ *  - none of the activities called from the activity, directly or
+ *    indirectly, is on the call stack.
+ */
+class activity_call_stack {
+public:
+    /**
+     * @brief Push a caller activity onto the call stack
+     *
+     * @param id Caller activity id
+     */
+    void push(eid_t id) { call_stack_[id]++; }
+
+    /**
+     * @brief Pop a caller activity from the call stack
+     *
+     * @param id Caller activity id
+     */
+    void pop(eid_t id)
+    {
+        if (auto it = call_stack_.find(id);
+            it != call_stack_.end() && --it->second == 0)
+            call_stack_.erase(it);
+    }
+
+    /**
+     * @brief Check whether a callee activity should be expanded
+     *
+     * Callees which are already on the call stack should not be expanded,
+     * in order to break infinite recursion on recursive calls.
+     *
+     * @param id Callee activity id
+     * @return True, if the callee is not on the call stack
+     */
+    bool should_expand(eid_t id)
+    {
+        // The output of activities being rendered depends on whether this
+        // callee is on the call stack
+        if (!frames_.empty())
+            frames_.back().callees.emplace(id);
+
+        return call_stack_.count(id) == 0;
+    }
+
+    /**
+     * @brief Mark the output of activities being rendered as dependent on
+     *        the generator state
+     */
+    void set_stateful()
+    {
+        if (!frames_.empty())
+            frames_.back().stateful = true;
+    }
+
+protected:
+    struct frame {
+        std::unordered_set<eid_t> callees;
+        bool stateful{false};
+    };
+
+    /**
+     * @brief Check whether any activity is being rendered
+     */
+    bool is_rendering() const { return !frames_.empty(); }
+
+    /**
+     * @brief Start rendering an activity
+     */
+    void begin_frame() { frames_.emplace_back(); }
+
+    /**
+     * @brief Finish rendering an activity
+     *
+     * @return Dependencies of the rendered activity output
+     */
+    frame end_frame()
+    {
+        auto f = std::move(frames_.back());
+        frames_.pop_back();
+
+        // The caller depends on everything the callee depends on
+        if (!frames_.empty()) {
+            auto &parent = frames_.back();
+            parent.stateful = parent.stateful || f.stateful;
+            parent.callees.insert(f.callees.begin(), f.callees.end());
+        }
+
+        return f;
+    }
+
+    /**
+     * @brief Check whether output with given dependencies can be memoized
+     */
+    bool is_reusable(const frame &f) const
+    {
+        return !f.stateful && !calls_any_on_stack(f.callees);
+    }
+
+    /**
+     * @brief Check whether memoized output can be reused and, if so, make
+     *        the activity being rendered depend on its callees
+     *
+     * @param callees Callees of the memoized activity
+     * @return True, if memoized output can be reused
+     */
+    bool reuse(const std::unordered_set<eid_t> &callees)
+    {
+        if (calls_any_on_stack(callees))
+            return false;
+
+        if (!frames_.empty())
+            frames_.back().callees.insert(callees.begin(), callees.end());
+
+        return true;
+    }
+
+private:
+    bool calls_any_on_stack(const std::unordered_set<eid_t> &callees) const
+    {
+        for (const auto &[id, count] : call_stack_) {
+            if (callees.count(id) > 0)
+                return true;
+        }
+
+        return false;
+    }
+
+    std::unordered_map<eid_t, unsigned> call_stack_;
+    std::vector<frame> frames_;
+};
+
+/**
+ * @brief Memoizes rendered activities as fragments of arbitrary type
+ *
+ * The output of an activity includes the output of all activities called
+ * from it, so in order to keep memory proportional to the output size, only
+ * activities which do not call other activities (leaf activities) are
+ * memoized.
+ *
+ * @tparam FragmentT Type of rendered activity output
+ */
+template <typename FragmentT>
+class activity_renderer : public activity_call_stack {
+public:
+    /**
+     * @brief Render activity, or reuse its memoized output
+     *
+     * @tparam GenerateF Type of functor rendering the activity
+     * @tparam ReplayF Type of functor writing memoized activity output
+     * @param id Activity id
+     * @param generate Renders the activity and returns the rendered output
+     * @param replay Writes memoized output of the activity
+     */
+    template <typename GenerateF, typename ReplayF>
+    void render(eid_t id, GenerateF &&generate, ReplayF &&replay)
+    {
+        if (auto it = memo_.find(id); it != memo_.end()) {
+            replay(it->second);
+            return;
+        }
+
+        begin_frame();
+
+        auto fragment = generate();
+
+        const auto f = end_frame();
+
+        if (f.callees.empty() && is_reusable(f))
+            memo_.try_emplace(id, std::move(fragment));
+    }
+
+private:
+    std::unordered_map<eid_t, FragmentT> memo_;
+};
+
+/**
+ * @brief Memoizes rendered activities of text based generators
+ *
+ * The output of all rendered activities is written to a single buffer,
+ * where the output of each activity includes the output of the activities
+ * called from it, so each memoized activity is only stored as a range of
+ * this buffer.
+ */
+class text_activity_renderer : public activity_call_stack {
+public:
+    /**
+     * @brief Render activity, or reuse its memoized output
+     *
+     * @tparam GenerateF Type of functor rendering the activity
+     * @param id Activity id
+     * @param ostr Output stream, for nested activities this is the stream
+     *             passed to `generate` of the calling activity
+     * @param generate Renders the activity to the stream passed to it
+     */
+    template <typename GenerateF>
+    void render(eid_t id, std::ostream &ostr, GenerateF &&generate)
+    {
+        const auto nested = is_rendering();
+
+        if (auto it = memo_.find(id);
+            it != memo_.end() && reuse(it->second.callees)) {
+            const auto &e = it->second;
+            if (nested)
+                buffer_.append(buffer_, e.offset, e.length);
+            else
+                ostr.write(buffer_.data() + e.offset,
+                    static_cast<std::streamsize>(e.length));
+            return;
+        }
+
+        const auto offset = buffer_.size();
+
+        begin_frame();
+
+        if (nested) {
+            generate(ostr);
+        }
+        else {
+            appender buf{buffer_};
+            std::ostream buffer_ostr{&buf};
+            generate(buffer_ostr);
+        }
+
+        auto f = end_frame();
+
+        const auto length = buffer_.size() - offset;
+
+        if (is_reusable(f)) {
+            memo_.try_emplace(
+                id, memo_entry{offset, length, std::move(f.callees)});
+            memoized_size_ = std::max(memoized_size_, offset + length);
+        }
+
+        if (!nested) {
+            ostr.write(buffer_.data() + offset,
+                static_cast<std::streamsize>(length));
+
+            // Only the output of memoized activities is needed later
+            buffer_.resize(memoized_size_);
+        }
+    }
+
+private:
+    /**
+     * @brief Stream buffer appending directly to a string, so that the
+     *        size of the string is always the current output position
+     */
+    class appender : public std::streambuf {
+    public:
+        explicit appender(std::string &str)
+            : str_{str}
+        {
+        }
+
+    protected:
+        int_type overflow(int_type c) override
+        {
+            if (!traits_type::eq_int_type(c, traits_type::eof()))
+                str_.push_back(traits_type::to_char_type(c));
+
+            return traits_type::not_eof(c);
+        }
+
+        std::streamsize xsputn(const char *s, std::streamsize n) override
+        {
+            str_.append(s, static_cast<std::size_t>(n));
+            return n;
+        }
+
+    private:
+        std::string &str_;
+    };
+
+    struct memo_entry {
+        std::size_t offset;
+        std::size_t length;
+        std::unordered_set<eid_t> callees;
+    };
+
+    std::string buffer_;
+    std::size_t memoized_size_{0};
+    std::unordered_map<eid_t, memo_entry> memo_;
+};
+
+} // namespace clanguml::sequence_diagram::generators
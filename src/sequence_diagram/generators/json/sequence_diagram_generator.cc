@@ -18,8 +18,24 @@
 
 #include "sequence_diagram_generator.h"
 
+#include <mutex>
+#include <random>
+
 namespace clanguml::sequence_diagram::generators::json {
 
+namespace {
+std::filesystem::path make_temporary_path()
+{
+    static std::mutex mutex;
+    static std::mt19937_64 random{std::random_device{}()};
+
+    std::lock_guard<std::mutex> l(mutex);
+
+    return std::filesystem::temp_directory_path() /
+        fmt::format("clang-uml-sequences-{:016x}.json", random());
+}
+} // namespace
+
 std::string render_name(std::string name)
 {
     util::replace_all(name, "##", "::");
@@ -76,6 +92,8 @@ generator::generator(
 {
 }
 
+generator::~generator() { remove_sequences_file(); }
+
 void generator::generate_call(const message &m, nlohmann::json &parent) const
 {
     const auto &from = model().get_participant<model::participant>(m.from());
@@ -185,14 +203,13 @@ void generator::generate_call(const message &m, nlohmann::json &parent) const
         m.from(), to, m.to());
 }
 
-void generator::generate_activity(
-    const activity &a, std::vector<eid_t> &visited) const
+void generator::generate_activity(const activity &a) const
 {
     // Generate calls from this activity to other activities
     for (const auto &m : a.messages()) {
         switch (m.type()) {
         case message_t::kCall:
-            process_call_message(m, visited);
+            process_call_message(m);
             break;
         case message_t::kIf:
             process_if_message(m);
@@ -262,39 +279,79 @@ nlohmann::json &generator::current_block_statement() const
     return block_statements_stack_.back().get();
 }
 
-void generator::process_call_message(
-    const model::message &m, std::vector<eid_t> &visited) const
+void generator::process_call_message(const model::message &m) const
 {
-    visited.push_back(m.from());
-
     if (m.in_static_declaration_context()) {
-        if (util::contains(already_generated_in_static_context_, m)) {
-            visited.pop_back();
+        // Output of this activity depends on where it was generated first
+        activity_renderer_.set_stateful();
+
+        if (util::contains(already_generated_in_static_context_, m))
             return;
-        }
 
         already_generated_in_static_context_.push_back(m);
     }
 
+    activity_renderer_.push(m.from());
+
     LOG_DBG("Generating message {} --> {}", m.from(), m.to());
 
     generate_call(m, current_block_statement());
 
     if (model().sequences().find(m.to()) != model().sequences().end()) {
-        if (std::find(visited.begin(), visited.end(), m.to()) ==
-            visited.end()) { // break infinite recursion on recursive calls
-
+        // break infinite recursion on recursive calls
+        if (activity_renderer_.should_expand(m.to())) {
             LOG_DBG("Creating activity {} --> {} - missing sequence {}",
                 m.from(), m.to(), m.to());
 
-            generate_activity(model().get_activity(m.to()), visited);
+            activity_renderer_.render(
+                m.to(),
+                [this, &m]() {
+                    return generate_callee_activity(
+                        model().get_activity(m.to()));
+                },
+                [this](const nlohmann::json &messages) {
+                    if (messages.empty())
+                        return;
+
+                    auto &block = current_block_statement();
+                    for (const auto &message : messages)
+                        block["messages"].push_back(message);
+                });
         }
     }
     else
         LOG_DBG("Skipping activity {} --> {} - missing sequence {}", m.from(),
             m.to(), m.to());
 
-    visited.pop_back();
+    activity_renderer_.pop(m.from());
+}
+
+nlohmann::json generator::generate_callee_activity(const activity &a) const
+{
+    auto &block = current_block_statement();
+    const auto block_statements_count = block_statements_stack_.size();
+    const auto messages_count =
+        block.contains("messages") ? block["messages"].size() : 0U;
+
+    generate_activity(a);
+
+    auto messages = nlohmann::json::array();
+
+    // Messages can only be reused if all block statements opened in the
+    // activity have been closed
+    if (block_statements_stack_.size() != block_statements_count ||
+        &current_block_statement() != &block) {
+        activity_renderer_.set_stateful();
+        return messages;
+    }
+
+    if (block.contains("messages")) {
+        const auto &block_messages = block["messages"];
+        for (auto i = messages_count; i < block_messages.size(); i++)
+            messages.push_back(block_messages[i]);
+    }
+
+    return messages;
 }
 
 void generator::process_while_message(const message &m) const
@@ -683,6 +740,8 @@ void generator::generate_diagram(nlohmann::json &parent) const
 {
     model().print();
 
+    remove_sequences_file();
+
     if (config().using_namespace)
         parent["using_namespace"] = config().using_namespace().to_string();
 
@@ -708,7 +767,9 @@ void generator::generate_diagram(nlohmann::json &parent) const
             continue;
 
         auto message_chains_unique = model().get_all_from_to_message_chains(
-            *from_activity_id, *to_activity_id);
+            *from_activity_id, *to_activity_id,
+            config().message_chain_max_depth(),
+            config().message_chain_max_count());
 
         nlohmann::json sequence;
         sequence["from_to"]["from"]["location"] = from_location.location;
@@ -738,7 +799,7 @@ void generator::generate_diagram(nlohmann::json &parent) const
 
         block_statements_stack_.pop_back();
 
-        parent["sequences"].push_back(std::move(sequence));
+        write_sequence(sequence);
     }
 
     for (const auto &to_location : config().to()) {
@@ -748,7 +809,8 @@ void generator::generate_diagram(nlohmann::json &parent) const
             continue;
 
         auto message_chains_unique = model().get_all_from_to_message_chains(
-            eid_t{}, to_activity_id.value());
+            eid_t{}, to_activity_id.value(), config().message_chain_max_depth(),
+            config().message_chain_max_count());
 
         nlohmann::json sequence;
         sequence["to"]["location"] = to_location.location;
@@ -774,7 +836,7 @@ void generator::generate_diagram(nlohmann::json &parent) const
 
         block_statements_stack_.pop_back();
 
-        parent["sequences"].push_back(std::move(sequence));
+        write_sequence(sequence);
     }
 
     for (const auto &sf : config().from()) {
@@ -798,9 +860,6 @@ void generator::generate_diagram(nlohmann::json &parent) const
                 continue;
             }
 
-            // Use this to break out of recurrent loops
-            std::vector<eid_t> visited_participants;
-
             const auto &from =
                 model().get_participant<model::function>(start_from);
 
@@ -822,8 +881,7 @@ void generator::generate_diagram(nlohmann::json &parent) const
 
             block_statements_stack_.push_back(std::ref(sequence));
 
-            generate_activity(
-                model().get_activity(start_from), visited_participants);
+            generate_activity(model().get_activity(start_from));
 
             block_statements_stack_.pop_back();
 
@@ -834,7 +892,7 @@ void generator::generate_diagram(nlohmann::json &parent) const
                     make_display_name(from.value().return_type());
             }
 
-            parent["sequences"].push_back(std::move(sequence));
+            write_sequence(sequence);
         }
         else {
             // TODO: Add support for other sequence start location types
@@ -852,6 +910,62 @@ void generator::generate_diagram(nlohmann::json &parent) const
     parent["participants"] = json_["participants"];
 }
 
+void generator::generate_streamed_members(
+    common::generators::json::streamed_members_t &members) const
+{
+    if (sequence_sizes_.empty())
+        return;
+
+    members.emplace("sequences", [this](common::generators::json::writer &w) {
+        sequences_.seekg(0);
+
+        std::string sequence;
+        w.begin_array();
+        for (const auto size : sequence_sizes_) {
+            sequence.resize(size);
+            sequences_.read(
+                sequence.data(), static_cast<std::streamsize>(size));
+            w.raw(sequence);
+        }
+        w.end_array();
+
+        remove_sequences_file();
+    });
+}
+
+void generator::write_sequence(const nlohmann::json &sequence) const
+{
+    if (!sequences_.is_open()) {
+        sequences_path_ = make_temporary_path();
+        sequences_.open(sequences_path_,
+            std::ios::in | std::ios::out | std::ios::trunc | std::ios::binary);
+
+        if (!sequences_.is_open())
+            throw std::runtime_error(
+                fmt::format("Cannot create temporary file {}",
+                    sequences_path_.string()));
+    }
+
+    const auto begin = sequences_.tellp();
+    sequences_ << sequence;
+    sequence_sizes_.push_back(
+        static_cast<std::size_t>(sequences_.tellp() - begin));
+}
+
+void generator::remove_sequences_file() const
+{
+    sequence_sizes_.clear();
+
+    if (sequences_.is_open())
+        sequences_.close();
+
+    if (!sequences_path_.empty()) {
+        std::error_code ec;
+        std::filesystem::remove(sequences_path_, ec);
+        sequences_path_.clear();
+    }
+}
+
 std::string generator::make_display_name(const std::string &full_name) const
 {
     auto result = config().simplify_template_type(full_name);
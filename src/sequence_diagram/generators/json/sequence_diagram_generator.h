@@ -19,6 +19,7 @@
 
 #include "common/generators/json/generator.h"
 #include "config/config.h"
+#include "sequence_diagram/generators/activity_renderer.h"
 #include "sequence_diagram/model/diagram.h"
 #include "util/util.h"
 
@@ -29,6 +30,8 @@
 #include <iostream>
 #include <optional>
 #include <sstream>
+#include <string>
+#include <vector>
 
 namespace clanguml::sequence_diagram::generators::json {
 
@@ -49,6 +52,13 @@ class generator : public common_generator<diagram_config, diagram_model> {
 public:
     generator(diagram_config &config, diagram_model &model);
 
+    generator(const generator &) = delete;
+    generator(generator &&) = delete;
+    generator &operator=(const generator &) = delete;
+    generator &operator=(generator &&) = delete;
+
+    ~generator() override;
+
     using common_generator<diagram_config, diagram_model>::generate;
 
     /**
@@ -61,6 +71,19 @@ public:
      */
     void generate_diagram(nlohmann::json &parent) const override;
 
+    /**
+     * @brief Write sequences generated by generate_diagram()
+     *
+     * Each sequence is serialized to a temporary file as soon as it is
+     * generated, as the participants written before the sequences are only
+     * known once all sequences have been generated. This way only a single
+     * sequence is kept in memory at a time.
+     *
+     * @param members Streamed members of the root JSON object
+     */
+    void generate_streamed_members(
+        common::generators::json::streamed_members_t &members) const override;
+
     /**
      * @brief Generate sequence diagram message.
      *
@@ -97,11 +120,8 @@ public:
      * @brief Generate sequence diagram activity.
      *
      * @param a Activity model
-     * @param visited List of already visited participants, this is necessary
-     *                for breaking infinite recursion on recursive calls
      */
-    void generate_activity(const sequence_diagram::model::activity &a,
-        std::vector<eid_t> &visited) const;
+    void generate_activity(const sequence_diagram::model::activity &a) const;
 
     /**
      * @brief Get reference to the current block statement.
@@ -124,14 +144,33 @@ private:
      */
     bool is_participant_generated(eid_t id) const;
 
+    /**
+     * @brief Write generated sequence to the temporary sequences file
+     *
+     * @param sequence Sequence JSON node
+     */
+    void write_sequence(const nlohmann::json &sequence) const;
+
+    /**
+     * @brief Close and remove the temporary sequences file, if any
+     */
+    void remove_sequences_file() const;
+
     /**
      * @brief Process call message
      *
      * @param m Message model
-     * @param visited List of already visited participants
      */
-    void process_call_message(
-        const model::message &m, std::vector<eid_t> &visited) const;
+    void process_call_message(const model::message &m) const;
+
+    /**
+     * @brief Generate activity called from the current block statement
+     *
+     * @param a Activity model
+     * @return Messages added to the current block statement
+     */
+    nlohmann::json generate_callee_activity(
+        const sequence_diagram::model::activity &a) const;
 
     /**
      * @brief Process `if` statement message
@@ -250,7 +289,17 @@ private:
     mutable std::vector<std::reference_wrapper<nlohmann::json>>
         block_statements_stack_;
 
+    // Temporary file with serialized sequences, written after the
+    // participants, which are only known once all sequences have been
+    // generated
+    mutable std::filesystem::path sequences_path_;
+    mutable std::fstream sequences_;
+    // Length of each serialized sequence in the temporary file
+    mutable std::vector<std::size_t> sequence_sizes_;
+
     mutable std::vector<model::message> already_generated_in_static_context_;
+
+    mutable activity_renderer<nlohmann::json> activity_renderer_;
 };
 
 } // namespace clanguml::sequence_diagram::generators::json
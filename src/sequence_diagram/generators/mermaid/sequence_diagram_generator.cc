@@ -192,11 +192,13 @@ void generator::generate_return(const message &m, std::ostream &ostr) const
     }
 }
 
-void generator::generate_activity(
-    const activity &a, std::ostream &ostr, std::vector<eid_t> &visited) const
+void generator::generate_activity(const activity &a, std::ostream &ostr) const
 {
     for (const auto &m : a.messages()) {
         if (m.in_static_declaration_context()) {
+            // Output of this activity depends on where it was generated first
+            activity_renderer_.set_stateful();
+
             if (util::contains(already_generated_in_static_context_, m))
                 continue;
 
@@ -207,24 +209,33 @@ void generator::generate_activity(
             const auto &to =
                 model().get_participant<model::participant>(m.to());
 
-            visited.push_back(m.from());
+            activity_renderer_.push(m.from());
 
             LOG_DBG("Generating message [{}] --> [{}]", m.from(), m.to());
 
+            const auto generated_participants_count =
+                generated_participants_.size();
+
             generate_call(m, ostr);
 
+            // Participants are generated on their first use
+            if (generated_participants_.size() != generated_participants_count)
+                activity_renderer_.set_stateful();
+
             std::string to_alias = generate_alias(to.value());
 
             ostr << indent(1) << "activate " << to_alias << '\n';
 
             if (model().sequences().find(m.to()) != model().sequences().end()) {
-                if (std::find(visited.begin(), visited.end(), m.to()) ==
-                    visited
-                        .end()) { // break infinite recursion on recursive calls
+                // break infinite recursion on recursive calls
+                if (activity_renderer_.should_expand(m.to())) {
                     LOG_DBG("Creating activity {} --> {} - missing sequence {}",
                         m.from(), m.to(), m.to());
-                    generate_activity(
-                        model().get_activity(m.to()), ostr, visited);
+                    activity_renderer_.render(
+                        m.to(), ostr, [this, &m](std::ostream &activity_ostr) {
+                            generate_activity(
+                                model().get_activity(m.to()), activity_ostr);
+                        });
                 }
             }
             else
@@ -235,7 +246,7 @@ void generator::generate_activity(
 
             ostr << indent(1) << "deactivate " << to_alias << '\n';
 
-            visited.pop_back();
+            activity_renderer_.pop(m.from());
         }
         else if (m.type() == message_t::kIf) {
             print_debug(m, ostr);
@@ -515,7 +526,9 @@ void generator::generate_diagram(std::ostream &ostr) const
             continue;
 
         auto message_chains_unique = model().get_all_from_to_message_chains(
-            *from_activity_id, *to_activity_id);
+            *from_activity_id, *to_activity_id,
+            config().message_chain_max_depth(),
+            config().message_chain_max_count());
 
         for (const auto &mc : message_chains_unique) {
             const auto &from =
@@ -549,8 +562,9 @@ void generator::generate_diagram(std::ostream &ostr) const
         if (!to_activity_id)
             continue;
 
-        auto message_chains_unique =
-            model().get_all_from_to_message_chains(eid_t{}, *to_activity_id);
+        auto message_chains_unique = model().get_all_from_to_message_chains(
+            eid_t{}, *to_activity_id, config().message_chain_max_depth(),
+            config().message_chain_max_count());
 
         for (const auto &mc : message_chains_unique) {
             const auto from_activity_id = mc.front().from();
@@ -602,9 +616,6 @@ void generator::generate_diagram(std::ostream &ostr) const
                 continue;
             }
 
-            // Use this to break out of recurrent loops
-            std::vector<eid_t> visited_participants;
-
             if (model().participants().count(start_from) == 0)
                 continue;
 
@@ -640,8 +651,7 @@ void generator::generate_diagram(std::ostream &ostr) const
 
             ostr << indent(1) << "activate " << from_alias << '\n';
 
-            generate_activity(
-                model().get_activity(start_from), ostr, visited_participants);
+            generate_activity(model().get_activity(start_from), ostr);
 
             if (from.value().type_name() == "method" ||
                 config().combine_free_functions_into_file_participants()) {
@@ -19,6 +19,7 @@
 
 #include "common/generators/plantuml/generator.h"
 #include "config/config.h"
+#include "sequence_diagram/generators/activity_renderer.h"
 #include "sequence_diagram/model/diagram.h"
 #include "sequence_diagram/visitor/translation_unit_visitor.h"
 #include "util/util.h"
@@ -109,11 +110,9 @@ public:
      *
      * @param a Activity model
      * @param ostr Output stream
-     * @param visited List of already visited participants, this is necessary
-     *                for breaking infinite recursion on recursive calls
      */
     void generate_activity(const clanguml::sequence_diagram::model::activity &a,
-        std::ostream &ostr, std::vector<eid_t> &visited) const;
+        std::ostream &ostr) const;
 
 private:
     /**
@@ -159,6 +158,7 @@ private:
 
     mutable std::set<eid_t> generated_participants_;
     mutable std::vector<model::message> already_generated_in_static_context_;
+    mutable text_activity_renderer activity_renderer_;
 };
 
 } // namespace plantuml
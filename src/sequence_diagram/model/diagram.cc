@@ -22,6 +22,8 @@
 
 #include <functional>
 #include <memory>
+#include <optional>
+#include <unordered_map>
 
 namespace clanguml::sequence_diagram::model {
 
@@ -276,91 +278,116 @@ std::optional<eid_t> diagram::get_from_activity_id(
 }
 
 std::vector<message_chain_t> diagram::get_all_from_to_message_chains(
-    const eid_t from_activity, const eid_t to_activity) const
+    const eid_t from_activity, const eid_t to_activity,
+    const unsigned max_depth, const unsigned max_chains) const
 {
-    std::vector<message_chain_t> message_chains_unique{};
-
-    // Message (call) chains matching the specified from_to condition
-    std::vector<message_chain_t> message_chains;
+    // Message chains are searched backwards starting from the 'to_activity'.
+    // Chains share their common suffixes in a tree of message nodes, where
+    // each node points to the next message towards the 'to_activity'.
+    struct chain_node {
+        const message *m;
+        std::optional<size_t> next;
+        unsigned depth;
+    };
+
+    std::vector<chain_node> nodes;
+
+    const auto add_node = [&nodes](const message *m,
+                              std::optional<size_t> next) {
+        nodes.push_back(
+            {m, next, next.has_value() ? nodes[*next].depth + 1 : 1U});
+        return nodes.size() - 1;
+    };
+
+    // Check if the chain ending at node already visits activity
+    const auto visits = [&nodes](size_t node, eid_t activity) {
+        for (std::optional<size_t> n{node}; n; n = nodes[*n].next) {
+            if (nodes[*n].m->to() == activity)
+                return true;
+        }
+        return false;
+    };
 
-    // First find all 'to_activity' call targets in the sequences, i.e.
-    // all messages pointing to the final 'to_activity' activity
+    // Index all calls by their callee, preserving the order of messages in
+    // the sequences
+    std::unordered_map<eid_t, std::vector<const message *>> callers;
     for (const auto &[k, v] : sequences()) {
         for (const auto &m : v.messages()) {
             if (m.type() != common::model::message_t::kCall)
                 continue;
 
-            if (m.to() == to_activity) {
-                message_chains.emplace_back();
-                message_chains.back().push_back(m);
-            }
+            callers[m.to()].push_back(&m);
+        }
+    }
+
+    const auto reached_max_chains = [max_chains](size_t count) {
+        return max_chains > 0 && count >= max_chains;
+    };
+
+    // Each message chain is represented by the node of its first (i.e.
+    // calling) message. First find all messages pointing to the final
+    // 'to_activity' activity
+    std::vector<size_t> message_chains;
+    if (auto it = callers.find(to_activity); it != callers.end()) {
+        for (const auto *m : it->second) {
+            if (reached_max_chains(message_chains.size()))
+                break;
+            message_chains.push_back(add_node(m, {}));
         }
     }
 
-    std::map<unsigned int, std::vector<model::message>> calls_to_current_chain;
-    std::map<unsigned int, message_chain_t> current_chain;
+    // Chains which cannot be extended anymore
+    std::vector<bool> complete(message_chains.size(), false);
+
+    // Alternative callers of chains found in the previous iteration, which
+    // start new chains
+    std::vector<std::pair<size_t, const message *>> branches;
 
     int iter = 0;
     while (true) {
-        bool added_message_to_some_chain{false};
-        // If target of current message matches any of the
-        // 'from' constraints in the last messages in
-        // current chains found on previous iteration - append
-        if (!calls_to_current_chain.empty()) {
-            for (auto &[message_chain_index, messages] :
-                calls_to_current_chain) {
-                for (auto &m : messages) {
-                    message_chains.push_back(
-                        current_chain[message_chain_index]);
-
-                    message_chains.back().push_back(std::move(m));
-                }
-            }
-            calls_to_current_chain.clear();
-        }
+        for (const auto &[chain, m] : branches) {
+            if (reached_max_chains(message_chains.size()))
+                break;
 
-        LOG_TRACE("Message chains after iteration {}", iter++);
-        int message_chain_index{};
-        for (const auto &mc : message_chains) {
-            LOG_TRACE("\t{}: {}", message_chain_index++,
-                fmt::join(util::map<std::string>(mc,
-                              [](const model::message &m) -> std::string {
-                                  return m.message_name();
-                              }),
-                    "<-"));
+            message_chains.push_back(add_node(m, chain));
+            complete.push_back(false);
         }
+        branches.clear();
 
+        LOG_TRACE("Message chains after iteration {}: {}", iter++,
+            message_chains.size());
+
+        bool added_message_to_some_chain{false};
         for (auto i = 0U; i < message_chains.size(); i++) {
-            auto &mc = message_chains[i];
-            current_chain[i] = mc;
-            for (const auto &[k, v] : sequences()) {
-                for (const auto &m : v.messages()) {
-                    if (m.type() != common::model::message_t::kCall)
-                        continue;
-
-                    // Ignore recursive calls and call loops
-                    if (m.to() == m.from() ||
-                        std::any_of(
-                            cbegin(mc), cend(mc), [&m](const auto &msg) {
-                                return msg.to() == m.from();
-                            })) {
-                        continue;
-                    }
+            if (complete[i])
+                continue;
 
-                    if (m.to() == mc.back().from()) {
-                        calls_to_current_chain[i].push_back(m);
-                        added_message_to_some_chain = true;
-                    }
-                }
-            }
+            const auto chain = message_chains[i];
+
+            complete[i] = true;
 
-            // If there are more than one call to the current chain,
-            // duplicate it as many times as there are calls - 1
-            if (calls_to_current_chain.count(i) > 0 &&
-                !calls_to_current_chain[i].empty()) {
-                mc.push_back(calls_to_current_chain[i][0]);
-                calls_to_current_chain[i].erase(
-                    calls_to_current_chain[i].begin());
+            if (max_depth > 0 && nodes[chain].depth >= max_depth)
+                continue;
+
+            auto it = callers.find(nodes[chain].m->from());
+            if (it == callers.end())
+                continue;
+
+            for (const auto *m : it->second) {
+                // Ignore recursive calls and call loops
+                if (m->to() == m->from() || visits(chain, m->from()))
+                    continue;
+
+                // Extend the current chain with the first caller, and
+                // start a new chain for each other caller
+                if (complete[i]) {
+                    message_chains[i] = add_node(m, chain);
+                    complete[i] = false;
+                    added_message_to_some_chain = true;
+                }
+                else {
+                    branches.emplace_back(chain, m);
+                }
             }
         }
 
@@ -369,22 +396,36 @@ std::vector<message_chain_t> diagram::get_all_from_to_message_chains(
             break;
     }
 
-    // Reverse the message chains order (they were added starting from
-    // the destination activity)
-    for (auto &mc : message_chains) {
-        std::reverse(mc.begin(), mc.end());
+    // Now collect the unique message chains starting from 'from_activity'
+    const auto hash_message = [](const message &m) {
+        return std::hash<eid_t>{}(m.from()) ^
+            (std::hash<eid_t>{}(m.to()) << 1U) ^
+            (std::hash<std::string>{}(m.message_name()) << 2U);
+    };
 
-        if (mc.empty())
-            continue;
+    std::vector<message_chain_t> message_chains_unique{};
+    std::unordered_multimap<size_t, size_t> message_chains_hashes;
 
-        if (std::find(message_chains_unique.begin(),
-                message_chains_unique.end(), mc) != message_chains_unique.end())
+    for (const auto chain : message_chains) {
+        if (from_activity.value() != 0 &&
+            nodes[chain].m->from() != from_activity)
             continue;
 
-        if (from_activity.value() == 0 ||
-            (mc.front().from() == from_activity)) {
-            message_chains_unique.push_back(mc);
+        message_chain_t mc;
+        size_t hash{nodes[chain].depth};
+        for (std::optional<size_t> n{chain}; n; n = nodes[*n].next) {
+            mc.push_back(*nodes[*n].m);
+            hash = hash * 31U + hash_message(mc.back());
         }
+
+        const auto [first, last] = message_chains_hashes.equal_range(hash);
+        if (std::any_of(first, last, [&](const auto &h) {
+                return message_chains_unique[h.second] == mc;
+            }))
+            continue;
+
+        message_chains_hashes.emplace(hash, message_chains_unique.size());
+        message_chains_unique.push_back(std::move(mc));
     }
 
     LOG_TRACE("Message chains unique", iter++);
@@ -587,6 +628,28 @@ void diagram::fold_or_end_block_statement(message &&m,
     }
 }
 
+void diagram::merge(diagram &&other)
+{
+    for (auto &[id, p] : other.participants_) {
+        participants_.try_emplace(id, std::move(p));
+    }
+
+    for (auto &[id, act] : other.activities_) {
+        auto it = activities_.find(id);
+        if (it == activities_.end()) {
+            activities_.emplace(id, std::move(act));
+            continue;
+        }
+
+        for (auto &m : act.messages()) {
+            it->second.add_message(std::move(m));
+        }
+    }
+
+    active_participants_.insert(
+        other.active_participants_.begin(), other.active_participants_.end());
+}
+
 void diagram::finalize()
 {
     // Apply diagram filters and remove any empty block statements
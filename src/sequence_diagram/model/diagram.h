@@ -255,10 +255,13 @@ public:
      *
      * @param from_activity Source activity for from_to message chain
      * @param to_activity Target activity for from_to message chain
+     * @param max_depth Maximum number of messages in a chain (0 - no limit)
+     * @param max_chains Maximum number of chains to search (0 - no limit)
      * @return List of message chains
      */
     std::vector<message_chain_t> get_all_from_to_message_chains(
-        eid_t from_activity, eid_t to_activity) const;
+        eid_t from_activity, eid_t to_activity, unsigned max_depth = 0,
+        unsigned max_chains = 0) const;
 
     /**
      * @brief Get id of a 'to' activity
@@ -287,6 +290,19 @@ public:
      */
     void finalize() override;
 
+    /**
+     * @brief Merge participants and activities from another partial diagram.
+     *
+     * This method is used to combine diagram models built from separate
+     * subsets of translation units. Participants already in the model take
+     * precedence, while messages of activities present in both models are
+     * appended in the same order as if the translation units were visited
+     * sequentially.
+     *
+     * @param other Diagram model to merge into this diagram
+     */
+    void merge(diagram &&other);
+
     /**
      * @brief Check whether the diagram is empty
      *
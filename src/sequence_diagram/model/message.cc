@@ -48,14 +48,20 @@ eid_t message::to() const { return to_; }
 
 void message::set_message_name(std::string name)
 {
-    message_name_ = std::move(name);
+    message_name_ = util::interned_string{name};
 }
 
-const std::string &message::message_name() const { return message_name_; }
+const std::string &message::message_name() const
+{
+    return message_name_.str();
+}
 
-void message::set_return_type(std::string t) { return_type_ = std::move(t); }
+void message::set_return_type(std::string t)
+{
+    return_type_ = util::interned_string{t};
+}
 
-const std::string &message::return_type() const { return return_type_; }
+const std::string &message::return_type() const { return return_type_.str(); }
 
 const std::optional<std::string> &message::comment() const { return comment_; }
 
@@ -19,6 +19,7 @@
 
 #include "common/model/enums.h"
 #include "participant.h"
+#include "util/interned_string.h"
 
 #include <string>
 #include <vector>
@@ -171,9 +172,9 @@ private:
 
     // This is only for better verbose messages, we cannot rely on this
     // always
-    std::string message_name_{};
+    util::interned_string message_name_{};
 
-    std::string return_type_{};
+    util::interned_string return_type_{};
 
     std::optional<std::string> condition_text_;
 
@@ -50,6 +50,19 @@ void class_::is_template_instantiation(bool is_template_instantiation)
 }
 
 std::string class_::full_name_no_ns() const
+{
+    return cached_full_name(full_name_t::kNoNamespace,
+        [this]() { return render_full_name_no_ns(); });
+}
+
+std::string class_::full_name(bool relative) const
+{
+    return cached_full_name(
+        relative ? full_name_t::kRelative : full_name_t::kAbsolute,
+        [this, relative]() { return render_full_name(relative); });
+}
+
+std::string class_::render_full_name_no_ns() const
 {
     using namespace clanguml::util;
 
@@ -62,7 +75,7 @@ std::string class_::full_name_no_ns() const
     return ostr.str();
 }
 
-std::string class_::full_name(bool relative) const
+std::string class_::render_full_name(bool relative) const
 {
     using namespace clanguml::util;
     using clanguml::common::model::namespace_;
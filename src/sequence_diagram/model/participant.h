@@ -196,14 +196,16 @@ public:
     eid_t lambda_operator_id() const { return lambda_operator_id_; }
 
 private:
+    std::string render_full_name(bool relative) const;
+
+    std::string render_full_name_no_ns() const;
+
     bool is_struct_{false};
     bool is_template_{false};
     bool is_template_instantiation_{false};
     bool is_alias_{false};
     bool is_lambda_{false};
     eid_t lambda_operator_id_{};
-
-    std::string full_name_;
 };
 
 /**
@@ -2020,25 +2020,28 @@ void translation_unit_visitor::pop_message_to_diagram(
     construct_expr_message_map_.erase(expr);
 }
 
-void translation_unit_visitor::finalize()
-{
-    resolve_ids_to_global();
+void translation_unit_visitor::finalize() { resolve_ids_to_global(); }
 
+void translation_unit_visitor::finalize_diagram(
+    clanguml::sequence_diagram::model::diagram &diagram,
+    const clanguml::config::sequence_diagram &config)
+{
     // Change all messages with target set to an id of a lambda expression to
     // to the ID of their operator() - this is necessary, as some calls to
     // lambda expressions are visited before the actual lambda expressions
-    // are visited...
-    ensure_lambda_messages_have_operator_as_target();
+    // are visited, possibly in another translation unit...
+    ensure_lambda_messages_have_operator_as_target(diagram);
 
-    if (config().inline_lambda_messages())
-        diagram().inline_lambda_operator_calls();
+    if (config.inline_lambda_messages())
+        diagram.inline_lambda_operator_calls();
 }
 
-void translation_unit_visitor::ensure_lambda_messages_have_operator_as_target()
+void translation_unit_visitor::ensure_lambda_messages_have_operator_as_target(
+    clanguml::sequence_diagram::model::diagram &diagram)
 {
-    for (auto &[id, activity] : diagram().sequences()) {
+    for (auto &[id, activity] : diagram.sequences()) {
         for (auto &m : activity.messages()) {
-            auto participant = diagram().get_participant<model::class_>(m.to());
+            auto participant = diagram.get_participant<model::class_>(m.to());
 
             if (participant && participant.value().is_lambda() &&
                 participant.value().lambda_operator_id().value() != 0) {
@@ -2192,18 +2195,14 @@ bool translation_unit_visitor::should_include(const clang::TagDecl *decl) const
     if (source_manager().isInSystemHeader(decl->getSourceRange().getBegin()))
         return false;
 
-    const auto decl_file = decl->getLocation().printToString(source_manager());
-
-    return diagram().should_include(
-               namespace_{decl->getQualifiedNameAsString()}) &&
-        diagram().should_include(common::model::source_file{decl_file});
+    return should_include_namespace(decl) &&
+        should_include_file(decl->getLocation());
 }
 
 bool translation_unit_visitor::should_include(
     const clang::LambdaExpr *expr) const
 {
-    const auto expr_file = expr->getBeginLoc().printToString(source_manager());
-    return diagram().should_include(common::model::source_file{expr_file});
+    return should_include_file(expr->getBeginLoc());
 }
 
 bool translation_unit_visitor::should_include(const clang::CallExpr *expr) const
@@ -2224,9 +2223,7 @@ bool translation_unit_visitor::should_include(const clang::CallExpr *expr) const
     if (!context().valid())
         return false;
 
-    const auto expr_file = expr->getBeginLoc().printToString(source_manager());
-
-    if (!diagram().should_include(common::model::source_file{expr_file}))
+    if (!should_include_file(expr->getBeginLoc()))
         return false;
 
     const auto *callee_decl = expr->getCalleeDecl();
@@ -2234,10 +2231,7 @@ bool translation_unit_visitor::should_include(const clang::CallExpr *expr) const
     if (callee_decl != nullptr) {
         const auto *callee_function = callee_decl->getAsFunction();
 
-        if ((callee_function == nullptr) || !should_include(callee_function))
-            return false;
-
-        return should_include(callee_function);
+        return (callee_function != nullptr) && should_include(callee_function);
     }
 
     return true;
@@ -2261,11 +2255,8 @@ bool translation_unit_visitor::should_include(
 bool translation_unit_visitor::should_include(
     const clang::FunctionDecl *decl) const
 {
-    const auto decl_file = decl->getLocation().printToString(source_manager());
-
-    return diagram().should_include(
-               namespace_{decl->getQualifiedNameAsString()}) &&
-        diagram().should_include(common::model::source_file{decl_file});
+    return should_include_namespace(decl) &&
+        should_include_file(decl->getLocation());
 }
 
 bool translation_unit_visitor::should_include(
@@ -2280,11 +2271,8 @@ bool translation_unit_visitor::should_include(
     if (source_manager().isInSystemHeader(decl->getSourceRange().getBegin()))
         return false;
 
-    const auto decl_file = decl->getLocation().printToString(source_manager());
-
-    return diagram().should_include(
-               namespace_{decl->getQualifiedNameAsString()}) &&
-        diagram().should_include(common::model::source_file{decl_file});
+    return should_include_namespace(decl) &&
+        should_include_file(decl->getLocation());
 }
 
 std::optional<std::string> translation_unit_visitor::get_expression_comment(
@@ -250,6 +250,16 @@ public:
      */
     void finalize();
 
+    /**
+     * @brief Finalize diagram model once all translation units are visited
+     *
+     * @param diagram Reference to the diagram model
+     * @param config Reference to the diagram configuration
+     */
+    static void finalize_diagram(
+        clanguml::sequence_diagram::model::diagram &diagram,
+        const clanguml::config::sequence_diagram &config);
+
     std::unique_ptr<sequence_diagram::model::class_> create_element(
         const clang::NamedDecl *decl) const;
 
@@ -489,7 +499,8 @@ private:
 
     void resolve_ids_to_global();
 
-    void ensure_lambda_messages_have_operator_as_target();
+    static void ensure_lambda_messages_have_operator_as_target(
+        clanguml::sequence_diagram::model::diagram &diagram);
 
     call_expression_context call_expression_context_;
 
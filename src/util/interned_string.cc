@@ -0,0 +1,94 @@
+/**
+ * @file src/util/interned_string.cc
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "interned_string.h"
+
+#include <array>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+namespace clanguml::util {
+
+namespace {
+/**
+ * Strings are distributed over multiple independently locked shards, to
+ * reduce contention when translation units are visited in parallel.
+ */
+class string_table {
+public:
+    const std::string *intern(std::string_view s)
+    {
+        if (s.empty())
+            return &empty();
+
+        auto &shard = shards_[std::hash<std::string_view>{}(s) % kShardCount];
+
+        std::lock_guard<std::mutex> l(shard.mutex);
+
+        // Look up the string before copying it, so that interning an already
+        // interned string does not allocate
+        if (auto it = shard.index.find(s); it != shard.index.end())
+            return it->second;
+
+        // Elements of deque are never moved when appending, so the pointers
+        // and the views of the index remain valid
+        const auto &value = shard.strings.emplace_back(s);
+        shard.index.emplace(value, &value);
+
+        return &value;
+    }
+
+    static const std::string &empty()
+    {
+        static const std::string kEmpty;
+        return kEmpty;
+    }
+
+private:
+    static constexpr std::size_t kShardCount{16};
+
+    struct shard_t {
+        std::mutex mutex;
+        std::deque<std::string> strings;
+        std::unordered_map<std::string_view, const std::string *> index;
+    };
+
+    std::array<shard_t, kShardCount> shards_;
+};
+
+string_table &table()
+{
+    // Intentionally never destroyed, so that interned strings remain valid
+    // in destructors of static objects
+    static auto *instance = new string_table{}; // NOLINT
+    return *instance;
+}
+} // namespace
+
+interned_string::interned_string()
+    : value_{&string_table::empty()}
+{
+}
+
+interned_string::interned_string(std::string_view s)
+    : value_{table().intern(s)}
+{
+}
+
+} // namespace clanguml::util
@@ -0,0 +1,94 @@
+/**
+ * @file src/util/interned_string.h
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace clanguml::util {
+
+/**
+ * @brief Handle to a string stored in a process-wide string table
+ *
+ * Diagram models store the same strings, e.g. source file paths, many times.
+ * Interned strings with the same value share a single copy, which is never
+ * released, so copying and comparing interned strings is a pointer operation.
+ *
+ * Strings can be interned concurrently from multiple threads.
+ */
+class interned_string {
+public:
+    /**
+     * @brief Construct an empty string
+     */
+    interned_string();
+
+    /**
+     * @brief Intern a string
+     *
+     * @param s String value
+     */
+    explicit interned_string(std::string_view s);
+
+    /**
+     * @brief Get the string value
+     *
+     * @return Reference to the interned string, valid until the program exits
+     */
+    const std::string &str() const { return *value_; }
+
+    /**
+     * @brief Check if the string is empty
+     *
+     * @return True, if the string is empty
+     */
+    bool empty() const { return value_->empty(); }
+
+    friend bool operator==(const interned_string &l, const interned_string &r)
+    {
+        return l.value_ == r.value_;
+    }
+
+    friend bool operator!=(const interned_string &l, const interned_string &r)
+    {
+        return !(l == r);
+    }
+
+    friend std::ostream &operator<<(
+        std::ostream &os, const interned_string &s)
+    {
+        return os << s.str();
+    }
+
+private:
+    const std::string *value_;
+};
+
+} // namespace clanguml::util
+
+namespace std {
+template <> struct hash<clanguml::util::interned_string> {
+    std::size_t operator()(const clanguml::util::interned_string &key) const
+    {
+        // Equal interned strings share the same address
+        return std::hash<const std::string *>{}(&key.str());
+    }
+};
+} // namespace std
@@ -18,16 +18,32 @@
 
 #include "thread_pool_executor.h"
 
+#include <algorithm>
+#include <exception>
+#include <iterator>
+
 namespace clanguml::util {
 
+namespace {
+thread_local thread_pool_executor *current_executor{nullptr};
+thread_local std::size_t current_queue{0};
+thread_local std::uint64_t current_task{0};
+} // namespace
+
 thread_pool_executor::thread_pool_executor(unsigned int pool_size)
-    : done_{false}
 {
     if (pool_size == 0U)
         pool_size = std::thread::hardware_concurrency();
 
+    if (pool_size == 0U)
+        pool_size = 1U;
+
+    for (auto i = 0U; i < pool_size; i++) {
+        queues_.emplace_back(std::make_unique<worker_queue>());
+    }
+
     for (auto i = 0U; i < pool_size; i++) {
-        threads_.emplace_back(&thread_pool_executor::worker, this);
+        threads_.emplace_back(&thread_pool_executor::worker, this, i);
     }
 }
 
@@ -35,54 +51,178 @@ thread_pool_executor::~thread_pool_executor() { stop(); }
 
 std::future<void> thread_pool_executor::add(std::function<void()> &&task)
 {
-    std::unique_lock<std::mutex> l(tasks_mutex_);
-
-    std::packaged_task<void()> ptask{std::move(task)};
-    auto res = ptask.get_future();
+    queued_task qtask;
+    qtask.task = std::packaged_task<void()>{std::move(task)};
+    auto res = qtask.task.get_future();
+
+    std::size_t index{0};
+    {
+        std::lock_guard<std::mutex> l(mutex_);
+        qtask.id = next_task_id_++;
+        if (current_executor == this) {
+            index = current_queue;
+            qtask.parent = current_task;
+        }
+        else {
+            index = next_queue_++ % queues_.size();
+        }
+    }
 
-    tasks_.emplace_back(std::move(ptask));
+    {
+        auto &queue = *queues_[index];
+        std::lock_guard<std::mutex> l(queue.mutex);
+        queue.tasks.emplace_back(std::move(qtask));
+    }
 
-    l.unlock();
-    tasks_cond_.notify_one();
+    {
+        std::lock_guard<std::mutex> l(mutex_);
+        pending_++;
+    }
+    cond_.notify_one();
 
     return res;
 }
 
+void thread_pool_executor::wait(std::future<void> &fut)
+{
+    if (current_executor != this) {
+        fut.get();
+        return;
+    }
+
+    // Only help with the tasks added by the waiting task, executing any
+    // other queued task here could block the waiting task until that
+    // unrelated task is finished
+    const auto parent = current_task;
+
+    while (fut.wait_for(std::chrono::seconds::zero()) !=
+        std::future_status::ready) {
+        auto task = take(current_queue, parent);
+
+        // Nothing left to help with - the awaited task is being executed
+        // by another thread
+        if (!task) {
+            fut.wait();
+            break;
+        }
+
+        run(*task);
+    }
+
+    fut.get();
+}
+
+void thread_pool_executor::wait(std::vector<std::future<void>> &futs)
+{
+    std::exception_ptr error;
+
+    for (auto &fut : futs) {
+        try {
+            wait(fut);
+        }
+        catch (...) {
+            if (!error)
+                error = std::current_exception();
+        }
+    }
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
+thread_pool_executor *thread_pool_executor::current()
+{
+    return current_executor;
+}
+
+std::size_t thread_pool_executor::size() const { return threads_.size(); }
+
 void thread_pool_executor::stop()
 {
-    done_ = true;
+    {
+        std::lock_guard<std::mutex> l(mutex_);
+        done_ = true;
+    }
+    cond_.notify_all();
+
     for (auto &thread : threads_) {
         if (thread.joinable())
             thread.join();
     }
 }
 
-void thread_pool_executor::worker()
+void thread_pool_executor::worker(std::size_t index)
 {
-    try {
-        while (!done_) {
-            auto task = get();
+    current_executor = this;
+    current_queue = index;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> l(mutex_);
+            cond_.wait(l, [this] { return pending_ > 0 || done_; });
 
-            task();
+            if (pending_ <= 0 && done_)
+                break;
         }
+
+        if (auto task = take(index); task)
+            run(*task);
     }
-    catch (std::runtime_error &e) {
-    }
+
+    current_executor = nullptr;
 }
 
-std::packaged_task<void()> thread_pool_executor::get()
+void thread_pool_executor::run(queued_task &task)
 {
-    std::unique_lock<std::mutex> l(tasks_mutex_);
+    const auto previous_task = current_task;
+    current_task = task.id;
+
+    task.task();
 
-    while (tasks_.empty()) {
-        if (done_)
-            throw std::runtime_error("Thread pool closing...");
+    current_task = previous_task;
+}
+
+std::optional<thread_pool_executor::queued_task> thread_pool_executor::take(
+    std::size_t index, std::optional<std::uint64_t> parent)
+{
+    std::optional<queued_task> res;
+
+    const auto matches = [&parent](const queued_task &t) {
+        return !parent || t.parent == *parent;
+    };
+
+    // Take the most recently added task from own queue first, then steal
+    // the oldest task from the other queues
+    for (auto i = 0U; i < queues_.size() && !res; i++) {
+        auto &queue = *queues_[(index + i) % queues_.size()];
+
+        std::lock_guard<std::mutex> l(queue.mutex);
+        if (queue.tasks.empty())
+            continue;
+
+        if (i == 0) {
+            auto it = std::find_if(
+                queue.tasks.rbegin(), queue.tasks.rend(), matches);
+            if (it != queue.tasks.rend()) {
+                res.emplace(std::move(*it));
+                queue.tasks.erase(std::next(it).base());
+            }
+        }
+        else {
+            auto it =
+                std::find_if(queue.tasks.begin(), queue.tasks.end(), matches);
+            if (it != queue.tasks.end()) {
+                res.emplace(std::move(*it));
+                queue.tasks.erase(it);
+            }
+        }
+    }
 
-        tasks_cond_.wait_for(l, std::chrono::seconds(1));
+    if (res) {
+        std::lock_guard<std::mutex> l(mutex_);
+        pending_--;
     }
 
-    auto res = std::move(tasks_.front());
-    tasks_.pop_front();
     return res;
 }
 
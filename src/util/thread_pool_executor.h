@@ -17,22 +17,48 @@
  */
 #pragma once
 
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
 #include <deque>
+#include <functional>
 #include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <thread>
 #include <vector>
 
 namespace clanguml::util {
 
 /**
- * @brief Simple thread pool executor for parallelizing diagram generation.
+ * @brief Work-stealing thread pool executor for parallelizing diagram
+ *        generation.
+ *
+ * Each worker thread has its own task queue. Tasks added from a worker
+ * thread (e.g. translation unit shards added by a diagram generation task)
+ * are pushed to the queue of that worker, while tasks added from other
+ * threads are distributed over the queues in a round-robin fashion.
+ *
+ * Workers take tasks from the back of their own queue, and when it is empty,
+ * steal tasks from the front of the queues of other workers. Idle workers
+ * sleep on a condition variable until a task is added or the pool is
+ * stopped.
+ *
+ * Tasks can add further tasks to the same pool and wait for them using
+ * `wait()`, which executes the queued tasks added by the waiting task while
+ * the awaited task is not finished, so that nested tasks do not require a
+ * separate pool. Tasks added by other tasks (e.g. other diagrams) are never
+ * executed by a waiting task, so that waiting on nested tasks does not
+ * depend on the duration of unrelated work.
  */
 class thread_pool_executor {
 public:
     /**
      * @brief Constructor
      *
-     * @param pool_size Number of threads in the pool
+     * @param pool_size Number of threads in the pool, if 0 the number of
+     *                  hardware threads is used
      */
     explicit thread_pool_executor(unsigned int pool_size);
 
@@ -52,22 +78,96 @@ public:
     std::future<void> add(std::function<void()> &&task);
 
     /**
-     * @brief Join all active threads in the pool
+     * @brief Wait for a task added to this pool to finish.
+     *
+     * When called from a task running in this pool, while the awaited task
+     * is not finished, the calling thread executes the queued tasks added
+     * by the calling task. Otherwise the calling thread blocks until the
+     * task is finished. Any exception thrown by the task is rethrown.
+     *
+     * @param fut Future returned by `add()`
+     */
+    void wait(std::future<void> &fut);
+
+    /**
+     * @brief Wait for all tasks added to this pool to finish.
+     *
+     * All tasks are awaited, even if some of them fail, after which the
+     * first exception thrown by any of the tasks is rethrown.
+     *
+     * @param futs Futures returned by `add()`
+     */
+    void wait(std::vector<std::future<void>> &futs);
+
+    /**
+     * @brief Get the pool, which the calling thread is a worker of.
+     *
+     * @return Pointer to the pool or nullptr if called outside of any pool
+     */
+    static thread_pool_executor *current();
+
+    /**
+     * @brief Get the number of threads in the pool
+     *
+     * @return Number of threads
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Execute the remaining tasks and join all threads in the pool
      */
     void stop();
 
 private:
+    struct queued_task {
+        std::packaged_task<void()> task;
+        // Id of the task
+        std::uint64_t id{0};
+        // Id of the task which added this task, 0 for tasks added from
+        // outside of the pool
+        std::uint64_t parent{0};
+    };
+
+    struct worker_queue {
+        std::mutex mutex;
+        std::deque<queued_task> tasks;
+    };
+
     /**
      * @brief Main worker pool thread method - take task from queue and execute
+     *
+     * @param index Index of the worker's queue
+     */
+    void worker(std::size_t index);
+
+    /**
+     * @brief Take a task from the queue at `index` or steal from other queues
+     *
+     * @param index Index of the queue to take the task from first
+     * @param parent If set, only tasks added by task with this id are taken
+     * @return Task, if any matching task was queued
+     */
+    std::optional<queued_task> take(
+        std::size_t index, std::optional<std::uint64_t> parent = {});
+
+    /**
+     * @brief Execute task, making it the current task of the calling thread
+     *
+     * @param task Task to execute
      */
-    void worker();
+    static void run(queued_task &task);
+
+    std::vector<std::unique_ptr<worker_queue>> queues_;
+    std::size_t next_queue_{0};
+    std::uint64_t next_task_id_{1};
 
-    std::packaged_task<void()> get();
+    // Number of queued tasks, can be temporarily negative when a task is
+    // taken before its addition is accounted for
+    std::ptrdiff_t pending_{0};
+    bool done_{false};
+    std::mutex mutex_;
+    std::condition_variable cond_;
 
-    std::atomic_bool done_;
-    std::deque<std::packaged_task<void()>> tasks_;
-    std::mutex tasks_mutex_;
-    std::condition_variable tasks_cond_;
     std::vector<std::thread> threads_;
 };
-} // namespace clanguml::util
\ No newline at end of file
+} // namespace clanguml::util
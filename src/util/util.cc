@@ -19,7 +19,13 @@
 
 #include <spdlog/spdlog.h>
 
+#include <array>
+#include <atomic>
+#include <mutex>
 #include <regex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
 #if __has_include(<sys/utsname.h>)
 #include <sys/utsname.h>
 #endif
@@ -65,8 +71,47 @@ private:
     int &result_;
     FILE *pipe_;
 };
+
+// Keeps the cached logger alive, even if it is dropped from spdlog registry
+std::mutex logger_mutex;
+std::shared_ptr<spdlog::logger> logger_instance;
+std::atomic<spdlog::logger *> logger_cache{nullptr};
+// Replaced loggers, which other threads can still use through the pointer
+// they loaded from logger_cache. Loggers are only replaced during setup, so
+// keeping them until exit is cheap.
+std::vector<std::shared_ptr<spdlog::logger>> replaced_loggers;
 } // namespace
 
+void register_logger(std::shared_ptr<spdlog::logger> logger)
+{
+    spdlog::drop(kLoggerName);
+    spdlog::register_logger(logger);
+
+    std::lock_guard<std::mutex> l(logger_mutex);
+    logger_cache.store(logger.get(), std::memory_order_release);
+    if (logger_instance)
+        replaced_loggers.emplace_back(std::move(logger_instance));
+    logger_instance = std::move(logger);
+}
+
+spdlog::logger *logger()
+{
+    if (auto *l = logger_cache.load(std::memory_order_acquire); l != nullptr)
+        return l;
+
+    auto registered = spdlog::get(kLoggerName);
+    if (!registered)
+        return nullptr;
+
+    std::lock_guard<std::mutex> l(logger_mutex);
+    if (!logger_instance) {
+        logger_cache.store(registered.get(), std::memory_order_release);
+        logger_instance = std::move(registered);
+    }
+
+    return logger_instance.get();
+}
+
 std::string get_process_output(const std::string &command)
 {
     constexpr size_t kBufferSize{1024};
@@ -410,6 +455,123 @@ std::size_t hash_seed(std::size_t seed)
     return kSeedStart + (seed << kSeedShiftFirst) + (seed >> kSeedShiftSecond);
 }
 
+namespace {
+constexpr std::array<std::uint64_t, 4> kWyhashSecret{0xa0761d6478bd642fULL,
+    0xe7037ed1a0b428dbULL, 0x8ebc6af09c88c6e3ULL, 0x589965cc75374cc3ULL};
+
+// Multiply a and b into a 128-bit value, and store its low and high
+// halves in a and b
+void wyhash_mum(std::uint64_t &a, std::uint64_t &b)
+{
+#if defined(__SIZEOF_INT128__)
+    const auto r = static_cast<unsigned __int128>(a) * b;
+    a = static_cast<std::uint64_t>(r);
+    b = static_cast<std::uint64_t>(r >> 64U);
+#else
+    const std::uint64_t ha = a >> 32U;
+    const std::uint64_t hb = b >> 32U;
+    const std::uint64_t la = static_cast<std::uint32_t>(a);
+    const std::uint64_t lb = static_cast<std::uint32_t>(b);
+    const std::uint64_t rh = ha * hb;
+    const std::uint64_t rm0 = ha * lb;
+    const std::uint64_t rm1 = hb * la;
+    const std::uint64_t rl = la * lb;
+    const std::uint64_t t = rl + (rm0 << 32U);
+    auto c = static_cast<std::uint64_t>(t < rl);
+    const std::uint64_t lo = t + (rm1 << 32U);
+    c += static_cast<std::uint64_t>(lo < t);
+    a = lo;
+    b = rh + (rm0 >> 32U) + (rm1 >> 32U) + c;
+#endif
+}
+
+std::uint64_t wyhash_mix(std::uint64_t a, std::uint64_t b)
+{
+    wyhash_mum(a, b);
+    return a ^ b;
+}
+
+// Read integers in little endian order, so that the hash does not depend
+// on the platform
+std::uint64_t wyhash_read(const char *p, unsigned bytes)
+{
+    std::uint64_t result{0};
+    for (auto i = 0U; i < bytes; i++)
+        result |= static_cast<std::uint64_t>(static_cast<unsigned char>(p[i]))
+            << (8U * i);
+    return result;
+}
+
+std::uint64_t wyhash_read64(const char *p) { return wyhash_read(p, 8); }
+
+std::uint64_t wyhash_read32(const char *p) { return wyhash_read(p, 4); }
+
+std::uint64_t wyhash_read3(const char *p, std::size_t k)
+{
+    return (static_cast<std::uint64_t>(static_cast<unsigned char>(p[0]))
+               << 16U) |
+        (static_cast<std::uint64_t>(static_cast<unsigned char>(p[k >> 1U]))
+            << 8U) |
+        static_cast<unsigned char>(p[k - 1]);
+}
+} // namespace
+
+std::uint64_t hash64(std::string_view data, std::uint64_t seed)
+{
+    const auto &s = kWyhashSecret;
+    const auto *p = data.data();
+    const auto len = data.size();
+
+    seed ^= wyhash_mix(seed ^ s[0], s[1]);
+
+    std::uint64_t a{0};
+    std::uint64_t b{0};
+
+    if (len <= 16) {
+        if (len >= 4) {
+            const auto offset = (len >> 3U) << 2U;
+            a = (wyhash_read32(p) << 32U) | wyhash_read32(p + offset);
+            b = (wyhash_read32(p + len - 4) << 32U) |
+                wyhash_read32(p + len - 4 - offset);
+        }
+        else if (len > 0) {
+            a = wyhash_read3(p, len);
+        }
+    }
+    else {
+        auto i = len;
+        if (i > 48) {
+            auto see1 = seed;
+            auto see2 = seed;
+            do {
+                seed = wyhash_mix(
+                    wyhash_read64(p) ^ s[1], wyhash_read64(p + 8) ^ seed);
+                see1 = wyhash_mix(
+                    wyhash_read64(p + 16) ^ s[2], wyhash_read64(p + 24) ^ see1);
+                see2 = wyhash_mix(
+                    wyhash_read64(p + 32) ^ s[3], wyhash_read64(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = wyhash_mix(
+                wyhash_read64(p) ^ s[1], wyhash_read64(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = wyhash_read64(p + i - 16);
+        b = wyhash_read64(p + i - 8);
+    }
+
+    a ^= s[1];
+    b ^= seed;
+    wyhash_mum(a, b);
+
+    return wyhash_mix(a ^ s[0] ^ len, b ^ s[1]);
+}
+
 std::string path_to_url(const std::filesystem::path &p)
 {
     std::vector<std::string> path_tokens;
@@ -460,6 +622,41 @@ bool is_relative_to(
     return starts_with(weakly_canonical(child), weakly_canonical(parent));
 }
 
+const normalized_path &normalize_path(
+    const std::filesystem::path &path, const std::filesystem::path &root)
+{
+    // Intentionally never destroyed, as the returned references can be
+    // held by other static objects
+    static auto *mutex = new std::shared_mutex{}; // NOLINT
+    static auto *cache =                          // NOLINT
+        new std::unordered_map<std::string, normalized_path>{};
+
+    // Relative paths are resolved against the current working directory,
+    // which changes between translation units, so the cache is keyed by
+    // the absolute path. This does not access the filesystem, except for
+    // getting the current working directory.
+    auto absolute = std::filesystem::absolute(path).lexically_normal();
+
+    auto key = root.string() + '\0' + absolute.string();
+
+    {
+        std::shared_lock<std::shared_mutex> l(*mutex);
+        if (auto it = cache->find(key); it != cache->end())
+            return it->second;
+    }
+
+    normalized_path result;
+    result.absolute = std::move(absolute);
+    result.relative = std::filesystem::relative(result.absolute, root);
+    result.is_relative_to_root = is_relative_to(result.absolute, root);
+
+    std::unique_lock<std::shared_mutex> l(*mutex);
+
+    // Elements of unordered_map are never moved, so the references remain
+    // valid after rehashing
+    return cache->try_emplace(std::move(key), std::move(result)).first->second;
+}
+
 std::string format_message_comment(const std::string &comment, unsigned width)
 {
     if (width == 0)
@@ -21,36 +21,44 @@
 #include <spdlog/spdlog.h>
 
 #include <algorithm>
+#include <cstdint>
 #include <cstring>
 #include <filesystem>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <vector>
 
+/**
+ * Logging macros
+ *
+ * The logger is looked up only once (see clanguml::util::logger()) and the
+ * arguments are evaluated only if the log level is enabled. `fmt__` must be
+ * a string literal.
+ */
+#define LOG_IMPL_(level__, fmt__, ...)                                         \
+    do {                                                                       \
+        if (auto *logger__ = clanguml::util::logger();                         \
+            logger__ != nullptr && logger__->should_log(level__))              \
+            logger__->log(level__, "[{}:{}] " fmt__, FILENAME_, __LINE__,      \
+                ##__VA_ARGS__);                                                \
+    } while (false)
+
 #define LOG_ERROR(fmt__, ...)                                                  \
-    spdlog::get("clanguml-logger")                                             \
-        ->error(fmt::runtime(std::string("[{}:{}] ") + fmt__), FILENAME_,      \
-            __LINE__, ##__VA_ARGS__)
+    LOG_IMPL_(spdlog::level::err, fmt__, ##__VA_ARGS__)
 
 #define LOG_WARN(fmt__, ...)                                                   \
-    spdlog::get("clanguml-logger")                                             \
-        ->warn(fmt::runtime(std::string("[{}:{}] ") + fmt__), FILENAME_,       \
-            __LINE__, ##__VA_ARGS__)
+    LOG_IMPL_(spdlog::level::warn, fmt__, ##__VA_ARGS__)
 
 #define LOG_INFO(fmt__, ...)                                                   \
-    spdlog::get("clanguml-logger")                                             \
-        ->info(fmt::runtime(std::string("[{}:{}] ") + fmt__), FILENAME_,       \
-            __LINE__, ##__VA_ARGS__)
+    LOG_IMPL_(spdlog::level::info, fmt__, ##__VA_ARGS__)
 
 #define LOG_DBG(fmt__, ...)                                                    \
-    spdlog::get("clanguml-logger")                                             \
-        ->debug(fmt::runtime(std::string("[{}:{}] ") + fmt__), FILENAME_,      \
-            __LINE__, ##__VA_ARGS__)
+    LOG_IMPL_(spdlog::level::debug, fmt__, ##__VA_ARGS__)
 
 #define LOG_TRACE(fmt__, ...)                                                  \
-    spdlog::get("clanguml-logger")                                             \
-        ->trace(fmt::runtime(std::string("[{}:{}] ") + fmt__), FILENAME_,      \
-            __LINE__, ##__VA_ARGS__)
+    LOG_IMPL_(spdlog::level::trace, fmt__, ##__VA_ARGS__)
 
 namespace clanguml::util {
 
@@ -59,6 +67,29 @@ namespace clanguml::util {
 
 constexpr unsigned kDefaultMessageCommentWidth{25U};
 
+constexpr auto kLoggerName{"clanguml-logger"};
+
+/**
+ * @brief Register the clang-uml logger
+ *
+ * Replaces any logger previously registered in spdlog registry under
+ * the clang-uml logger name. The replaced logger is kept alive, as other
+ * threads may still be using it.
+ *
+ * @param logger Logger instance
+ */
+void register_logger(std::shared_ptr<spdlog::logger> logger);
+
+/**
+ * @brief Get the clang-uml logger
+ *
+ * The logger is cached after the first lookup in the spdlog registry, which
+ * requires a mutex, and is updated by register_logger().
+ *
+ * @return Pointer to the logger or nullptr, if no logger is registered
+ */
+spdlog::logger *logger();
+
 /**
  * @brief Left trim a string
  *
@@ -422,6 +453,19 @@ template <typename F> void _if(const bool condition, F &&func)
  */
 std::size_t hash_seed(std::size_t seed);
 
+/**
+ * @brief Calculate 64-bit hash of a string
+ *
+ * This is a fast, non-cryptographic hash based on wyhash. Unlike std::hash,
+ * its value is the same on all platforms, standard libraries and releases,
+ * so it can be used for identifiers stored outside of the process.
+ *
+ * @param data Input data
+ * @param seed Hash seed
+ * @return Hash value
+ */
+std::uint64_t hash64(std::string_view data, std::uint64_t seed = 0);
+
 /**
  * @brief Convert filesystem path to url path
  *
@@ -457,6 +501,33 @@ std::filesystem::path ensure_path_is_absolute(const std::filesystem::path &p,
 bool is_relative_to(
     const std::filesystem::path &parent, const std::filesystem::path &child);
 
+/**
+ * @brief Normalized forms of a file path with respect to a root directory
+ */
+struct normalized_path {
+    /*! Absolute path in normal form */
+    std::filesystem::path absolute;
+    /*! Path relative to the root directory */
+    std::filesystem::path relative;
+    /*! True, if the path is located in the root directory */
+    bool is_relative_to_root{false};
+};
+
+/**
+ * @brief Get normalized forms of a file path
+ *
+ * Making paths relative resolves them through the filesystem, so the
+ * results are cached for the entire run and shared by all threads. Relative
+ * paths are first made absolute using the current working directory. This
+ * assumes that the files do not change during the run.
+ *
+ * @param path Path to the file
+ * @param root Root directory
+ * @return Reference to the cached normalized forms of the path
+ */
+const normalized_path &normalize_path(
+    const std::filesystem::path &path, const std::filesystem::path &root);
+
 std::string format_message_comment(
     const std::string &c, unsigned width = kDefaultMessageCommentWidth);
 
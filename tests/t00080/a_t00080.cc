@@ -0,0 +1,12 @@
+#include "t00080.h"
+
+namespace clanguml {
+namespace t00080 {
+
+template <typename T> struct A<T, std::string> {
+    T t;
+    std::string name;
+};
+
+}
+}
@@ -0,0 +1,11 @@
+#include "t00080.h"
+
+namespace clanguml {
+namespace t00080 {
+
+struct B {
+    A<int, std::string> a;
+};
+
+}
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <string>
+
+namespace clanguml {
+namespace t00080 {
+
+template <typename T, typename P> struct A {
+    T t;
+    P p;
+};
+
+}
+}
@@ -0,0 +1,54 @@
+/**
+ * tests/t00080/test_case.h
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+TEST_CASE("t00080")
+{
+    using namespace clanguml::test;
+
+    auto [config, db, diagram, model] =
+        CHECK_CLASS_MODEL("t00080", "t00080_class");
+
+    CHECK_CLASS_DIAGRAM(*config, diagram, *model, [](const auto &src) {
+        REQUIRE(IsClassTemplate(src, "A<T,P>"));
+        REQUIRE(IsClassTemplate(src, "A<T,std::string>"));
+        REQUIRE(IsClass(src, "B"));
+
+        // The specialization is only visible in a_t00080.cc, and the
+        // instantiation only in b_t00080.cc
+        REQUIRE(
+            IsInstantiation(src, "A<T,std::string>", "A<int,std::string>"));
+        REQUIRE(IsAggregation<Public>(src, "B", "A<int,std::string>", "a"));
+    });
+
+    // Generating the diagram with the translation units split between
+    // threads must give the same result
+    auto sharded_model = clanguml::common::generators::generate<
+        clanguml::class_diagram::model::diagram,
+        clanguml::config::class_diagram,
+        clanguml::class_diagram::visitor::translation_unit_visitor>(*db,
+        diagram->name,
+        dynamic_cast<clanguml::config::class_diagram &>(*diagram),
+        diagram->get_translation_units(), false, {}, 2);
+
+    REQUIRE(render_class_diagram<plantuml_t>(diagram, *model).src ==
+        render_class_diagram<plantuml_t>(diagram, *sharded_model).src);
+    REQUIRE(render_class_diagram<json_t>(diagram, *model).src ==
+        render_class_diagram<json_t>(diagram, *sharded_model).src);
+    REQUIRE(render_class_diagram<mermaid_t>(diagram, *model).src ==
+        render_class_diagram<mermaid_t>(diagram, *sharded_model).src);
+}
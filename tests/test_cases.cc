@@ -553,6 +553,7 @@ void CHECK_INCLUDE_DIAGRAM(const clanguml::config::config &config,
 #include "t00077/test_case.h"
 #include "t00078/test_case.h"
 #include "t00079/test_case.h"
+#include "t00080/test_case.h"
 
 ///
 /// Sequence diagram tests
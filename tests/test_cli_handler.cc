@@ -390,6 +390,46 @@ TEST_CASE("Test cli handler puml config inheritance with render cmd")
         "' test comment");
 }
 
+TEST_CASE("Test cli handler shared AST option")
+{
+    using clanguml::cli::cli_flow_t;
+    using clanguml::cli::cli_handler;
+
+    std::vector<const char *> argv{
+        "clang-uml", "--config", "./test_config_data/simple.yml"};
+
+    std::ostringstream ostr;
+    cli_handler cli{ostr, make_sstream_logger(ostr)};
+
+    auto res = cli.handle_options(argv.size(), argv.data());
+
+    REQUIRE(res == cli_flow_t::kContinue);
+    REQUIRE_FALSE(cli.get_runtime_config().shared_ast);
+    REQUIRE(cli.get_runtime_config().tu_thread_count == 1);
+
+    argv.push_back("--shared-ast");
+    argv.push_back("-t");
+    argv.push_back("3");
+
+    cli_handler cli_shared{ostr, make_sstream_logger(ostr)};
+
+    res = cli_shared.handle_options(argv.size(), argv.data());
+
+    REQUIRE(res == cli_flow_t::kContinue);
+    REQUIRE(cli_shared.get_runtime_config().shared_ast);
+    REQUIRE(cli_shared.get_runtime_config().tu_thread_count == 3);
+
+    argv.push_back("--tu-thread-count");
+    argv.push_back("2");
+
+    cli_handler cli_shared_tu{ostr, make_sstream_logger(ostr)};
+
+    res = cli_shared_tu.handle_options(argv.size(), argv.data());
+
+    REQUIRE(res == cli_flow_t::kContinue);
+    REQUIRE(cli_shared_tu.get_runtime_config().tu_thread_count == 2);
+}
+
 TEST_CASE("Test cli handler properly initializes new config file")
 {
     using clanguml::cli::cli_flow_t;
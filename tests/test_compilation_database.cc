@@ -26,6 +26,9 @@
 #include <spdlog/sinks/ostream_sink.h>
 #include <spdlog/spdlog.h>
 
+#include <filesystem>
+#include <fstream>
+
 std::shared_ptr<spdlog::logger> make_sstream_logger(std::ostream &ostr)
 {
     auto oss_sink = std::make_shared<spdlog::sinks::ostream_sink_mt>(ostr);
@@ -104,6 +107,66 @@ TEST_CASE("Test compilation_database should throw")
         compilation_database_error);
 }
 
+#if !defined(_WIN32)
+TEST_CASE("Test compilation_database executes query driver once")
+{
+    using clanguml::util::contains;
+    namespace fs = std::filesystem;
+
+    const auto directory =
+        fs::temp_directory_path() / "clanguml_test_query_driver";
+    fs::remove_all(directory);
+    fs::create_directories(directory);
+
+    const auto driver = directory / "driver.sh";
+    const auto invocations = directory / "invocations";
+
+    {
+        std::ofstream ofs{driver};
+        ofs << "#!/bin/sh\n"
+            << "echo \"$@\" >> " << invocations.string() << "\n"
+            << "echo 'Target: test-target'\n"
+            << "echo '#include <...> search starts here:'\n"
+            << "echo ' /test/include'\n"
+            << "echo 'End of search list.'\n";
+    }
+    fs::permissions(driver, fs::perms::owner_all);
+
+    auto cfg =
+        clanguml::config::load("./test_compilation_database_data/config.yml");
+    cfg.query_driver.set(driver.string());
+
+    const auto db =
+        clanguml::common::compilation_database::auto_detect_from_directory(
+            cfg);
+
+    const auto first = db->getAllCompileCommands();
+    const auto second = db->getAllCompileCommands();
+
+    // All translation units are C++, so the driver is executed only once
+    std::ifstream ifs{invocations};
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(ifs, line);)
+        lines.push_back(line);
+
+    REQUIRE(lines.size() == 1);
+    CHECK(lines[0] == "-E -v -x c++ /dev/null");
+
+    REQUIRE(first.size() == 3);
+    REQUIRE(second.size() == 3);
+
+    for (auto i = 0U; i < first.size(); i++) {
+        const auto &command_line = first[i].CommandLine;
+
+        CHECK(command_line == second[i].CommandLine);
+        CHECK(contains(command_line, "--target=test-target"));
+        CHECK(contains(command_line, "/test/include"));
+    }
+
+    fs::remove_all(directory);
+}
+#endif
+
 ///
 /// Main test function
 ///
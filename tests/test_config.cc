@@ -442,6 +442,44 @@ TEST_CASE("Test config type aliases")
         "std::vector<std::string>");
 }
 
+TEST_CASE("Test type_alias_matcher")
+{
+    using clanguml::config::type_alias_matcher;
+
+    type_alias_matcher matcher{{{"std::basic_string<char>", "std::string"},
+        {"std::basic_string", "std::string"},
+        {"std::vector<std::string>", "strings_t"}, {"", "empty"}}};
+
+    CHECK(matcher.simplify("int") == "int");
+    CHECK(matcher.simplify("") == "");
+    CHECK(matcher.simplify("std::basic_string<char>") == "std::string");
+    CHECK(matcher.simplify("std::basic_string<wchar_t>") ==
+        "std::string<wchar_t>");
+    CHECK(matcher.simplify("std::map<std::basic_string<char>,int>") ==
+        "std::map<std::string,int>");
+    // Replacements can create new matches
+    CHECK(matcher.simplify("std::vector<std::basic_string<char>>") ==
+        "strings_t");
+    // Results are memoized
+    CHECK(matcher.simplify("std::vector<std::basic_string<char>>") ==
+        "strings_t");
+
+    // Longer patterns are replaced first, in the entire type name
+    type_alias_matcher overlapping{{{"ab", "X"}, {"bcd", "Y"}}};
+    CHECK(overlapping.simplify("abcd") == "aY");
+    CHECK(overlapping.simplify("ab<bcd>") == "X<Y>");
+
+    // Memoized results are discarded when the cache is full
+    type_alias_matcher bounded{{{"a", "b"}}, 2};
+    CHECK(bounded.simplify("int") == "int");
+    CHECK(bounded.cache_size() == 0);
+    CHECK(bounded.simplify("a1") == "b1");
+    CHECK(bounded.simplify("a2") == "b2");
+    CHECK(bounded.cache_size() == 2);
+    CHECK(bounded.simplify("a3") == "b3");
+    CHECK(bounded.cache_size() == 1);
+}
+
 ///
 /// Main test function
 ///
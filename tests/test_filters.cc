@@ -27,6 +27,8 @@
 #include "include_diagram/model/diagram.h"
 #include "sequence_diagram/model/diagram.h"
 
+#include <algorithm>
+#include <chrono>
 #include <filesystem>
 
 TEST_CASE("Test diagram paths filter")
@@ -54,6 +56,69 @@ TEST_CASE("Test diagram paths filter")
         make_path("sequence_diagram/visitor/translation_unit_visitor.h")));
 }
 
+TEST_CASE("Test paths_filter with overlapping paths")
+{
+    using clanguml::common::model::filter_t;
+    using clanguml::common::model::paths_filter;
+    using clanguml::common::model::source_file;
+    using clanguml::common::model::tvl::is_true;
+    namespace fs = std::filesystem;
+
+    const auto root =
+        fs::canonical(fs::temp_directory_path()) / "clanguml_test_paths_filter";
+    fs::remove_all(root);
+    for (const auto *dir : {"a/b", "a/bc", "a/b-x"})
+        fs::create_directories(root / dir);
+
+    clanguml::include_diagram::model::diagram diagram;
+
+    // Paths next to and inside the configured paths, including paths which
+    // sort right before or right after them
+    const std::vector<std::string> candidates{"a", "a/a", "a/a/z", "a/b",
+        "a/b/c", "a/b-", "a/b-x", "a/b-x/y", "a/ba", "a/bc", "a/bc/d", "a/bd",
+        "a0", "b", "0"};
+
+    auto matching = [&](const std::vector<std::string> &paths) {
+        const paths_filter filter{filter_t::kInclusive, root, paths};
+
+        std::vector<std::string> result;
+        for (const auto &candidate : candidates) {
+            const auto path = root / candidate;
+            const auto matches =
+                is_true(filter.match(diagram, source_file{path}));
+
+            // Same result as checking each configured path separately
+            CHECK(matches ==
+                std::any_of(paths.begin(), paths.end(), [&](const auto &p) {
+                    return clanguml::util::starts_with(path, root / p);
+                }));
+
+            if (matches)
+                result.push_back(candidate);
+        }
+        return result;
+    };
+
+    // Nested paths
+    CHECK(matching({"a/b", "a"}) ==
+        std::vector<std::string>{"a", "a/a", "a/a/z", "a/b", "a/b/c", "a/b-",
+            "a/b-x", "a/b-x/y", "a/ba", "a/bc", "a/bc/d", "a/bd", "a0"});
+
+    // Paths are matched as string prefixes, like util::starts_with() does
+    CHECK(matching({"a/b"}) ==
+        std::vector<std::string>{"a/b", "a/b/c", "a/b-", "a/b-x", "a/b-x/y",
+            "a/ba", "a/bc", "a/bc/d", "a/bd"});
+    CHECK(matching({"a/bc", "a/b"}) == matching({"a/b"}));
+
+    // Sibling paths sharing a prefix, sorted on both sides of 'a/b/'
+    CHECK(matching({"a/bc", "a/b-x"}) ==
+        std::vector<std::string>{"a/b-x", "a/b-x/y", "a/bc", "a/bc/d"});
+
+    CHECK(matching({}).empty());
+
+    fs::remove_all(root);
+}
+
 TEST_CASE("Test method_types include filter")
 {
     using clanguml::class_diagram::model::class_method;
@@ -169,6 +234,15 @@ TEST_CASE("Test namespaces filter")
     p.set_name("interface");
 
     CHECK(!filter.should_include(p));
+
+    // Namespace verdicts cached in the diagram must match the filter
+    diagram.set_filter(std::make_unique<diagram_filter>(diagram, config));
+
+    for (auto i = 0; i < 2; i++) {
+        CHECK(diagram.should_include(namespace_{"ns1::ns2"}));
+        CHECK(!diagram.should_include(namespace_{"ns1::ns2::detail"}));
+        CHECK(!diagram.should_include(namespace_{"ns1::interface"}));
+    }
 }
 
 TEST_CASE("Test elements regexp filter")
@@ -270,6 +344,98 @@ TEST_CASE("Test namespaces regexp filter")
     CHECK(filter.should_include(p));
 }
 
+TEST_CASE("Test namespace_filter with literal and regex patterns")
+{
+    using clanguml::common::namespace_or_regex;
+    using clanguml::common::model::filter_t;
+    using clanguml::common::model::namespace_;
+    using clanguml::common::model::namespace_filter;
+
+    clanguml::class_diagram::model::diagram diagram;
+
+    const std::vector<namespace_or_regex> namespaces{namespace_{"ns1::ns2"},
+        {std::regex{"ns3::.*"}, "ns3::.*"},
+        {std::regex{"(ns4)::\\1"}, "(ns4)::\\1"},
+        {std::regex{"ns5|ns6"}, "ns5|ns6"}};
+
+    namespace_filter inclusive{filter_t::kInclusive, namespaces};
+
+    CHECK(inclusive.match(diagram, namespace_{"ns1"}).value());
+    CHECK(inclusive.match(diagram, namespace_{"ns1::ns2"}).value());
+    CHECK(inclusive.match(diagram, namespace_{"ns1::ns2::detail"}).value());
+    CHECK(!inclusive.match(diagram, namespace_{"ns1::ns3"}).value());
+    CHECK(inclusive.match(diagram, namespace_{"ns3::A"}).value());
+    CHECK(inclusive.match(diagram, namespace_{"ns4::ns4"}).value());
+    CHECK(!inclusive.match(diagram, namespace_{"ns4::ns5"}).value());
+    CHECK(inclusive.match(diagram, namespace_{"ns6"}).value());
+    CHECK(!inclusive.match(diagram, namespace_{"ns7"}).value());
+
+    namespace_filter exclusive{filter_t::kExclusive, namespaces};
+
+    CHECK(!exclusive.match(diagram, namespace_{"ns1"}).value());
+    CHECK(exclusive.match(diagram, namespace_{"ns1::ns2::detail"}).value());
+    CHECK(exclusive.match(diagram, namespace_{"ns5"}).value());
+
+    namespace_filter empty{filter_t::kInclusive, {}};
+
+    CHECK(!empty.match(diagram, namespace_{"ns1"}).has_value());
+}
+
+TEST_CASE("Test namespace_filter combined regex is faster than separate")
+{
+    using clanguml::common::namespace_or_regex;
+    using clanguml::common::model::filter_t;
+    using clanguml::common::model::namespace_;
+    using clanguml::common::model::namespace_filter;
+    using std::chrono::steady_clock;
+
+    clanguml::class_diagram::model::diagram diagram;
+
+    std::vector<namespace_or_regex> namespaces;
+    std::vector<clanguml::common::regex> regexes;
+    for (auto i = 0; i < 64; i++) {
+        const auto pattern = fmt::format("ns{}::(detail|impl)::.*", i);
+        namespaces.emplace_back(std::regex{pattern}, pattern);
+        regexes.emplace_back(std::regex{pattern}, pattern);
+    }
+
+    namespace_filter filter{filter_t::kExclusive, namespaces};
+
+    std::vector<std::string> names;
+    for (auto i = 0; i < 200; i++)
+        names.emplace_back(fmt::format("clanguml::common::model::ns{}", i));
+
+    auto best_of = [](auto &&f) {
+        auto best = steady_clock::duration::max();
+        for (auto i = 0; i < 5; i++) {
+            const auto start = steady_clock::now();
+            f();
+            best = std::min(best, steady_clock::now() - start);
+        }
+        return best;
+    };
+
+    auto matched{0};
+
+    const auto combined = best_of([&]() {
+        for (const auto &name : names) {
+            if (filter.match(diagram, namespace_{name}).value())
+                matched++;
+        }
+    });
+
+    const auto separate = best_of([&]() {
+        for (const auto &name : names) {
+            if (std::any_of(regexes.begin(), regexes.end(),
+                    [&name](const auto &r) { return r %= name; }))
+                matched++;
+        }
+    });
+
+    CHECK(matched == 0);
+    CHECK(combined < separate);
+}
+
 TEST_CASE("Test subclasses regexp filter")
 {
     using clanguml::class_diagram::model::class_method;
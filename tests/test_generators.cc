@@ -0,0 +1,333 @@
+/**
+ * @file tests/test_generators.cc
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#define DOCTEST_CONFIG_IMPLEMENT
+
+#include "doctest/doctest.h"
+
+#include "cli/cli_handler.h"
+#include "common/compilation_database.h"
+#include "common/generators/diagram_renderer.h"
+#include "common/generators/diagram_skip_cache.h"
+#include "common/generators/json/writer.h"
+
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+
+TEST_CASE("Test diagram_skip_cache")
+{
+    using clanguml::common::generators::diagram_skip_cache;
+    using clanguml::common::generators::translation_unit_dependencies;
+    namespace fs = std::filesystem;
+
+    auto cfg =
+        clanguml::config::load("./test_compilation_database_data/config.yml");
+    const auto db =
+        clanguml::common::compilation_database::auto_detect_from_directory(
+            cfg);
+
+    const auto directory =
+        fs::temp_directory_path() / "clanguml_test_diagram_skip_cache";
+    fs::remove_all(directory);
+    fs::create_directories(directory);
+
+    const auto source = (directory / "main.cc").string();
+    const auto output = directory / "main_diagram.puml";
+
+    auto write_file = [](const fs::path &path, const std::string &content) {
+        std::ofstream ofs{path, std::ofstream::out | std::ofstream::trunc};
+        ofs << content;
+    };
+
+    write_file(source, "int main() { return 0; }");
+    write_file(output, "@startuml\n@enduml\n");
+
+    // Each diagram_skip_cache instance represents a single run
+    diagram_skip_cache cache{directory / "cache"};
+    translation_unit_dependencies dependencies{cache.hashes()};
+    dependencies.add(source, source);
+
+    REQUIRE_FALSE(
+        cache.is_up_to_date("main_diagram", "key", *db, {source}, {output}));
+
+    cache.update("main_diagram", "key", *db, {source}, dependencies);
+
+    REQUIRE(
+        cache.is_up_to_date("main_diagram", "key", *db, {source}, {output}));
+    REQUIRE_FALSE(cache.is_up_to_date(
+        "main_diagram", "other_key", *db, {source}, {output}));
+    REQUIRE_FALSE(
+        cache.is_up_to_date("main_diagram", "key", *db, {}, {output}));
+
+    write_file(source, "int main() { return 1; }");
+
+    diagram_skip_cache next_cache{directory / "cache"};
+
+    REQUIRE_FALSE(next_cache.is_up_to_date(
+        "main_diagram", "key", *db, {source}, {output}));
+
+    // Files modified after they have been read must not be stored with
+    // their new hashes
+    next_cache.update("main_diagram", "key", *db, {source}, dependencies);
+
+    diagram_skip_cache third_cache{directory / "cache"};
+
+    REQUIRE_FALSE(third_cache.is_up_to_date(
+        "main_diagram", "key", *db, {source}, {output}));
+
+    translation_unit_dependencies new_dependencies{third_cache.hashes()};
+    new_dependencies.add(source, source);
+    third_cache.update("main_diagram", "key", *db, {source}, new_dependencies);
+
+    REQUIRE(third_cache.is_up_to_date(
+        "main_diagram", "key", *db, {source}, {output}));
+
+    fs::remove(output);
+
+    REQUIRE_FALSE(third_cache.is_up_to_date(
+        "main_diagram", "key", *db, {source}, {output}));
+
+    write_file(output, "@startuml\n@enduml\n");
+    third_cache.update("main_diagram", "key", *db, {source}, new_dependencies);
+    third_cache.invalidate("main_diagram");
+
+    REQUIRE_FALSE(third_cache.is_up_to_date(
+        "main_diagram", "key", *db, {source}, {output}));
+
+    fs::remove_all(directory);
+}
+
+TEST_CASE("Test translation_unit_dependencies hashes each file once")
+{
+    using clanguml::common::generators::file_hashes;
+    using clanguml::common::generators::translation_unit_dependencies;
+    namespace fs = std::filesystem;
+
+    const auto directory =
+        fs::temp_directory_path() / "clanguml_test_translation_unit_deps";
+    fs::remove_all(directory);
+    fs::create_directories(directory);
+
+    const auto header = (directory / "header.h").string();
+    const auto missing = (directory / "missing.h").string();
+
+    auto write_file = [](const fs::path &path, const std::string &content) {
+        std::ofstream ofs{path, std::ofstream::out | std::ofstream::trunc};
+        ofs << content;
+    };
+
+    write_file(header, "#pragma once");
+
+    file_hashes hashes;
+    translation_unit_dependencies dependencies{hashes};
+
+    dependencies.add("a.cc", header);
+    dependencies.add("a.cc", missing);
+
+    // The header is not read again for another translation unit
+    write_file(header, "#pragma once\nint a;");
+    dependencies.add("b.cc", header);
+
+    const auto a_files = dependencies.get("a.cc");
+    const auto b_files = dependencies.get("b.cc");
+
+    REQUIRE(a_files.size() == 1);
+    REQUIRE(b_files.size() == 1);
+    REQUIRE(a_files.at(header) == b_files.at(header));
+    REQUIRE(dependencies.get("c.cc").empty());
+
+    file_hashes new_hashes;
+    REQUIRE(new_hashes.get(header) != hashes.get(header));
+    REQUIRE_FALSE(new_hashes.get(missing).has_value());
+
+    fs::remove_all(directory);
+}
+
+TEST_CASE("Test diagram_renderer batch command")
+{
+    using clanguml::common::generators::diagram_renderer;
+
+    REQUIRE(diagram_renderer::make_batch_command(
+                "plantuml -tsvg {}.puml", {"A", "B"}) ==
+        "plantuml -tsvg A.puml B.puml");
+
+    REQUIRE(diagram_renderer::make_batch_command(
+                "/usr/bin/plantuml -tsvg \"diagrams/{}.puml\"", {"A", "B"}) ==
+        "/usr/bin/plantuml -tsvg \"diagrams/A.puml\" \"diagrams/B.puml\"");
+
+    REQUIRE(diagram_renderer::make_batch_command(
+                "plantuml \"my diagrams/{}.puml\" -tsvg", {"A", "B", "C"}) ==
+        "plantuml \"my diagrams/A.puml\" \"my diagrams/B.puml\" "
+        "\"my diagrams/C.puml\" -tsvg");
+}
+
+TEST_CASE("Test json writer output matches nlohmann::json")
+{
+    using clanguml::common::generators::json::streamed_members_t;
+    using clanguml::common::generators::json::write_object;
+    using clanguml::common::generators::json::writer;
+
+    const nlohmann::json element_a{{"name", "A<\"T\">"}, {"is_struct", true},
+        {"source_location", {{"file", "a.h"}, {"line", 12}}}};
+    const nlohmann::json element_b{{"name", "B\n\u0105"}, {"weight", 1.5}};
+
+    nlohmann::json diagram;
+    diagram["name"] = "diagram_\u00e9";
+    diagram["diagram_type"] = "class";
+    diagram["metadata"]["clang_uml_version"] = "0.0.0";
+    diagram["title"] = nullptr;
+
+    nlohmann::json expected_json = diagram;
+    expected_json["elements"].push_back(element_a);
+    expected_json["elements"].push_back(element_b);
+    expected_json["relationships"] = nlohmann::json::array();
+
+    std::ostringstream expected;
+    expected << expected_json;
+
+    streamed_members_t streamed;
+    streamed.emplace("elements", [&](writer &w) {
+        w.begin_array();
+        w.value(element_a);
+        w.raw(element_b.dump());
+        w.end_array();
+    });
+    streamed.emplace("relationships", [](writer &w) {
+        w.begin_array();
+        w.end_array();
+    });
+
+    std::ostringstream actual;
+    writer w{actual};
+    write_object(w, diagram, streamed);
+
+    REQUIRE(actual.str() == expected.str());
+}
+
+#if defined(__linux) || defined(__unix)
+TEST_CASE("Test diagram_renderer reports rendering results")
+{
+    using clanguml::common::generator_type_t;
+    using clanguml::common::generators::diagram_renderer;
+
+    auto make_diagram = [](const std::string &name, const std::string &cmd) {
+        auto d = std::make_shared<clanguml::config::class_diagram>();
+        d->name = name;
+        d->puml().cmd = cmd;
+        return d;
+    };
+
+    std::mutex results_mutex;
+    std::map<std::string, bool> results;
+    auto on_done = [&](const std::string &name) {
+        return [&, name](bool success) {
+            std::lock_guard<std::mutex> l(results_mutex);
+            results.emplace(name, success);
+        };
+    };
+
+    diagram_renderer renderer{2};
+
+    const auto a = make_diagram("A", "true {}");
+    const auto b = make_diagram("B", "false {}");
+
+    REQUIRE(renderer.add(generator_type_t::plantuml, a, on_done("A")));
+    REQUIRE(renderer.add(generator_type_t::plantuml, b, on_done("B")));
+    REQUIRE_FALSE(renderer.add(generator_type_t::json, a, on_done("A")));
+
+    renderer.wait();
+
+    REQUIRE(results.size() == 2);
+    CHECK(results.at("A"));
+    CHECK_FALSE(results.at("B"));
+}
+
+TEST_CASE("Test diagram_renderer reports only invalid diagrams in a batch")
+{
+    using clanguml::common::generator_type_t;
+    using clanguml::common::generators::diagram_renderer;
+
+    auto make_diagram = [](const std::string &name, const std::string &cmd) {
+        auto d = std::make_shared<clanguml::config::class_diagram>();
+        d->name = name;
+        d->puml().cmd = cmd;
+        return d;
+    };
+
+    std::mutex results_mutex;
+    std::map<std::string, bool> results;
+    auto on_done = [&](const std::string &name) {
+        return [&, name](bool success) {
+            std::lock_guard<std::mutex> l(results_mutex);
+            results.emplace(name, success);
+        };
+    };
+
+    diagram_renderer renderer{1};
+
+    // Keep the only render thread busy, so that the following diagrams are
+    // rendered in a single batch
+    REQUIRE(renderer.add(generator_type_t::plantuml,
+        make_diagram("Z", "sleep 0.2 && true {}"), on_done("Z")));
+
+    // Fails if any of the arguments is 'B'
+    const std::string cmd{
+        "sh -c 'for f in \"$@\"; do [ \"$f\" != B ] || exit 1; done' sh {}"};
+
+    for (const auto *name : {"A", "B", "C"}) {
+        REQUIRE(renderer.add(generator_type_t::plantuml,
+            make_diagram(name, cmd), on_done(name)));
+    }
+
+    renderer.wait();
+
+    REQUIRE(results.size() == 4);
+    CHECK(results.at("Z"));
+    CHECK(results.at("A"));
+    CHECK_FALSE(results.at("B"));
+    CHECK(results.at("C"));
+}
+#endif
+
+///
+/// Main test function
+///
+int main(int argc, char *argv[])
+{
+    doctest::Context context;
+
+    context.applyCommandLine(argc, argv);
+
+    clanguml::cli::cli_handler clih;
+
+    std::vector<const char *> argvv = {
+        "clang-uml", "--config", "./test_config_data/simple.yml"};
+
+    argvv.push_back("-q");
+
+    clih.handle_options(argvv.size(), argvv.data());
+
+    int res = context.run();
+
+    if (context.shouldExit())
+        return res;
+
+    return res;
+}
@@ -20,10 +20,18 @@
 #include "doctest/doctest.h"
 
 #include "class_diagram/model/class.h"
+#include "class_diagram/model/diagram.h"
+#include "common/clang_utils.h"
 #include "common/model/namespace.h"
 #include "common/model/package.h"
 #include "common/model/path.h"
+#include "common/model/relationship_graph.h"
 #include "common/model/template_parameter.h"
+#include "sequence_diagram/generators/activity_renderer.h"
+#include "sequence_diagram/model/diagram.h"
+
+#include <sstream>
+#include <utility>
 
 TEST_CASE("Test namespace_")
 {
@@ -471,6 +479,513 @@ TEST_CASE("Test common::model::package full_name")
     }
 }
 
+TEST_CASE("Test class_ full_name cache invalidation")
+{
+    using clanguml::class_diagram::model::class_;
+    using clanguml::common::model::namespace_;
+    using clanguml::common::model::template_parameter;
+
+    auto c = class_(namespace_{"ns1"});
+    c.set_name("A");
+    c.set_namespace(namespace_{"ns1"});
+
+    CHECK(c.full_name(false) == "ns1::A");
+    CHECK(c.full_name(true) == "A");
+    CHECK(c.full_name_no_ns() == "A");
+
+    c.add_template(template_parameter::make_argument("int"));
+
+    CHECK(c.full_name(false) == "ns1::A<int>");
+    CHECK(c.full_name(true) == "A<int>");
+    CHECK(c.full_name_no_ns() == "A<int>");
+
+    c.set_namespace(namespace_{"ns1::ns2"});
+
+    CHECK(c.full_name(false) == "ns1::ns2::A<int>");
+    CHECK(c.full_name(true) == "ns2::A<int>");
+
+    c.set_name("B");
+
+    CHECK(c.full_name(false) == "ns1::ns2::B<int>");
+    CHECK(c.full_name_no_ns() == "B<int>");
+}
+
+TEST_CASE("Test diagram_element::add_relationship")
+{
+    using clanguml::class_diagram::model::class_;
+    using clanguml::common::eid_t;
+    using clanguml::common::model::access_t;
+    using clanguml::common::model::namespace_;
+    using clanguml::common::model::relationship;
+    using clanguml::common::model::relationship_t;
+
+    auto c = class_(namespace_{"ns1"});
+    c.set_name("A");
+    c.set_id(eid_t{uint64_t{1}});
+
+    const auto B = eid_t{uint64_t{2}};
+    const auto C = eid_t{uint64_t{3}};
+
+    c.add_relationship({relationship_t::kAssociation, B});
+    c.add_relationship({relationship_t::kAssociation, B});
+    c.add_relationship({relationship_t::kAssociation, B, access_t::kPublic,
+        "b"});
+    c.add_relationship({relationship_t::kDependency, B});
+    c.add_relationship({relationship_t::kDependency, C});
+    c.add_relationship({relationship_t::kDependency, C});
+    c.add_relationship({relationship_t::kInstantiation, c.id()});
+
+    const auto &rels = std::as_const(c).relationships();
+    REQUIRE(rels.size() == 4);
+    CHECK(rels[0] == relationship{relationship_t::kAssociation, B});
+    CHECK(rels[1].label() == "b");
+    CHECK(rels[2] == relationship{relationship_t::kDependency, B});
+    CHECK(rels[3] == relationship{relationship_t::kDependency, C});
+
+    // Relationships modified in place are reindexed on next insertion
+    c.relationships().erase(c.relationships().begin());
+    c.relationships().front().set_destination(C);
+
+    c.add_relationship({relationship_t::kAssociation, B});
+    c.add_relationship({relationship_t::kAssociation, C, access_t::kPublic,
+        "b"});
+
+    REQUIRE(rels.size() == 4);
+    CHECK(rels[0].type() == relationship_t::kAssociation);
+    CHECK(rels[0].destination() == C);
+    CHECK(rels[0].label() == "b");
+    CHECK(rels[3] == relationship{relationship_t::kAssociation, B});
+}
+
+TEST_CASE("Test class_diagram::model::diagram merge")
+{
+    using clanguml::class_diagram::model::class_;
+    using clanguml::class_diagram::model::diagram;
+    using clanguml::common::to_id;
+    using clanguml::common::model::namespace_;
+    using clanguml::common::model::package;
+    using clanguml::common::model::relationship_t;
+    using namespace std::string_literals;
+
+    auto make_diagram = [](const std::vector<std::string> &names) {
+        auto d = std::make_unique<diagram>();
+
+        auto p = std::make_unique<package>(namespace_{});
+        p->set_namespace({});
+        p->set_name("ns1");
+        p->set_id(to_id("ns1"s));
+        d->add(namespace_{}, std::move(p));
+
+        for (const auto &name : names) {
+            auto c = std::make_unique<class_>(namespace_{});
+            c->set_namespace(namespace_{"ns1"});
+            c->set_name(name);
+            c->set_id(to_id("ns1::"s + name));
+            d->add(namespace_{"ns1"}, std::move(c));
+        }
+
+        return d;
+    };
+
+    auto d1 = make_diagram({"A", "B"});
+    auto d2 = make_diagram({"B", "C"});
+
+    d1->merge(std::move(*d2));
+
+    REQUIRE(d1->classes().size() == 3);
+    CHECK(d1->classes()[0].get().name() == "A");
+    CHECK(d1->classes()[1].get().name() == "B");
+    CHECK(d1->classes()[2].get().name() == "C");
+
+    CHECK(d1->find<class_>("ns1::C").has_value());
+    CHECK(d1->get_element<package>(namespace_{"ns1"}).has_value());
+
+    // Classes only forward declared in the first shard are replaced with
+    // their definitions from the following shards
+    auto d3 = make_diagram({"A", "B"});
+    auto d4 = make_diagram({"B"});
+
+    auto &b = d4->find<class_>("ns1::B").value();
+    b.complete(true);
+    b.add_relationship({relationship_t::kAssociation, to_id("ns1::A"s)});
+
+    d3->merge(std::move(*d4));
+
+    REQUIRE(d3->classes().size() == 2);
+    CHECK(d3->classes()[1].get().complete());
+    CHECK(d3->classes()[1].get().relationships().size() == 1);
+    CHECK(d3->find<class_>("ns1::B").value().complete());
+    CHECK(d3->find<class_>(to_id("ns1::B"s)).value().complete());
+    CHECK(d3->get_element<class_>(namespace_{"ns1::B"}).value().complete());
+}
+
+TEST_CASE("Test class_diagram::model::diagram element lookup")
+{
+    using clanguml::class_diagram::model::class_;
+    using clanguml::class_diagram::model::diagram;
+    using clanguml::class_diagram::model::enum_;
+    using clanguml::common::eid_t;
+    using clanguml::common::to_id;
+    using clanguml::common::model::namespace_;
+    using namespace std::string_literals;
+
+    diagram d;
+
+    auto c = std::make_unique<class_>(namespace_{});
+    c->set_namespace(namespace_{});
+    c->set_name("A");
+    c->set_id(to_id("A"s));
+    d.add(namespace_{}, std::move(c));
+
+    c = std::make_unique<class_>(namespace_{});
+    c->set_namespace(namespace_{});
+    c->set_name("A##B");
+    c->set_id(to_id("A##B"s));
+    d.add(namespace_{}, std::move(c));
+
+    auto e = std::make_unique<enum_>(namespace_{});
+    e->set_namespace(namespace_{});
+    e->set_name("E");
+    e->set_id(to_id("E"s));
+    d.add(namespace_{}, std::move(e));
+
+    // Adding an element with the same id again is ignored
+    c = std::make_unique<class_>(namespace_{});
+    c->set_namespace(namespace_{});
+    c->set_name("A");
+    c->set_id(to_id("A"s));
+    CHECK_FALSE(d.add(namespace_{}, std::move(c)));
+    CHECK(d.classes().size() == 2);
+
+    CHECK(d.find<class_>("A").has_value());
+    CHECK(d.find<class_>("A##B").has_value());
+    CHECK(d.find<class_>("A::B").value().id() == to_id("A##B"s));
+    CHECK_FALSE(d.find<class_>("E").has_value());
+    CHECK(d.find<enum_>("E").has_value());
+    CHECK(d.get("E").has_value());
+
+    CHECK(d.find<class_>(to_id("A"s)).value().name() == "A");
+    CHECK(d.has_element(to_id("E"s)));
+    CHECK_FALSE(d.has_element(eid_t{uint64_t{1}}));
+    CHECK(d.to_alias(to_id("A##B"s)) ==
+        d.find<class_>("A::B").value().alias());
+}
+
+TEST_CASE("Test nested_trait element index")
+{
+    using clanguml::class_diagram::model::class_;
+    using clanguml::common::model::element;
+    using clanguml::common::model::namespace_;
+    using clanguml::common::model::package;
+    using clanguml::common::model::template_parameter;
+
+    auto make_class = [](const std::string &name,
+                          const std::string &argument = {}) {
+        auto c = std::make_unique<class_>(namespace_{});
+        c->set_namespace(namespace_{});
+        c->set_name(name);
+        if (!argument.empty())
+            c->add_template(template_parameter::make_argument(argument));
+        return c;
+    };
+
+    auto make_package = [](const std::string &name) {
+        auto p = std::make_unique<package>(namespace_{});
+        p->set_namespace(namespace_{});
+        p->set_name(name);
+        return p;
+    };
+
+    package root{namespace_{}};
+
+    // Elements with the same name are not necessarily equal
+    CHECK(root.add_element(make_class("A", "int")));
+    CHECK(root.add_element(make_class("A", "double")));
+    CHECK(root.add_element(make_class("B")));
+    CHECK(root.add_element(make_package("ns1")));
+    CHECK_FALSE(root.add_element(make_class("A", "double")));
+    CHECK_FALSE(root.add_element(make_class("B")));
+
+    CHECK(root.add_element(namespace_{"ns1"}, make_class("C")));
+    CHECK_FALSE(root.add_element(namespace_{"ns1"}, make_class("C")));
+
+    CHECK(root.has_element("A"));
+    CHECK_FALSE(root.has_element("C"));
+    CHECK_FALSE(root.get_element<class_>("C").has_value());
+    CHECK_FALSE(root.get_element<package>("B").has_value());
+    CHECK(root.get_element<package>("ns1").has_value());
+    CHECK(root.get_element<class_>(namespace_{"ns1::C"}).has_value());
+
+    // The first element added with a name is returned
+    CHECK(root.get_element<class_>("A").value().full_name(false) ==
+        "A<int>");
+
+    // Merge new and duplicate elements, at the current and nested levels
+    package other{namespace_{}};
+    CHECK(other.add_element(make_class("A", "double")));
+    CHECK(other.add_element(make_class("A", "char")));
+    CHECK(other.add_element(make_package("ns1")));
+    CHECK(other.add_element(namespace_{"ns1"}, make_class("C")));
+    CHECK(other.add_element(namespace_{"ns1"}, make_class("D")));
+    CHECK(other.add_element(make_class("E")));
+
+    std::vector<std::string> moved;
+    root.merge_elements(
+        other, [&](element &e) { moved.push_back(e.full_name(false)); },
+        [](element & /*existing*/, element & /*duplicate*/) {
+            return false;
+        });
+
+    CHECK(moved == std::vector<std::string>{"A<char>", "D", "E"});
+
+    std::vector<std::string> names;
+    for (const auto &e : root)
+        names.push_back(e->full_name(false));
+    CHECK(names ==
+        std::vector<std::string>{
+            "A<int>", "A<double>", "B", "ns1", "A<char>", "E"});
+
+    CHECK_FALSE(root.add_element(make_class("A", "char")));
+    CHECK_FALSE(root.add_element(make_class("E")));
+    CHECK_FALSE(root.add_element(namespace_{"ns1"}, make_class("D")));
+    CHECK(root.get_element<class_>(namespace_{"ns1::D"}).has_value());
+
+    // Duplicates are left in the merged element and remain indexed
+    CHECK(other.has_element("A"));
+    CHECK(other.has_element("ns1"));
+    CHECK_FALSE(other.has_element("E"));
+    CHECK(other.get_element<class_>("A").value().full_name(false) ==
+        "A<double>");
+    CHECK_FALSE(other.add_element(make_class("A", "double")));
+    CHECK(other.add_element(make_class("A", "char")));
+
+    // Replace an existing element with its duplicate
+    package replacements{namespace_{}};
+    auto b = make_class("B");
+    b->complete(true);
+    CHECK(replacements.add_element(std::move(b)));
+
+    root.merge_elements(
+        replacements, [](element & /*e*/) {},
+        [](element & /*existing*/, element &duplicate) {
+            return duplicate.complete();
+        });
+
+    CHECK(root.get_element<class_>("B").value().complete());
+    CHECK(root.begin()[2]->complete());
+    CHECK_FALSE(root.add_element(make_class("B")));
+
+    CHECK_FALSE(replacements.get_element<class_>("B").value().complete());
+    CHECK_FALSE(replacements.add_element(make_class("B")));
+}
+
+TEST_CASE("Test relationship_graph")
+{
+    using namespace clanguml::common::model;
+    using clanguml::common::eid_t;
+    using direction_t = relationship_graph::direction_t;
+
+    const eid_t A{uint64_t{1}}, B{uint64_t{2}}, C{uint64_t{3}},
+        D{uint64_t{4}}, E{uint64_t{5}};
+
+    // A -> B -> C -> D, A -- E, B -> <not a node>
+    relationship_graph g;
+    for (const auto id : {A, B, C, D, E})
+        g.add_node(id);
+
+    g.add_edge(A, B, relationship_t::kAssociation);
+    g.add_edge(B, C, relationship_t::kAssociation);
+    g.add_edge(C, D, relationship_t::kDependency);
+    g.add_edge(A, E, relationship_t::kExtension);
+    g.add_edge(B, eid_t{uint64_t{100}}, relationship_t::kAssociation);
+
+    const auto association = relationship_mask(relationship_t::kAssociation);
+    const auto all = relationship_mask({relationship_t::kAssociation,
+        relationship_t::kDependency, relationship_t::kExtension});
+
+    std::unordered_set<eid_t> adjacent;
+    g.adjacent(B, association, direction_t::kOutgoing, adjacent);
+    CHECK(adjacent == std::unordered_set<eid_t>{C});
+
+    adjacent.clear();
+    g.adjacent(B, association, direction_t::kIncoming, adjacent);
+    CHECK(adjacent == std::unordered_set<eid_t>{A});
+
+    CHECK(g.reachable({A}, association, 0) ==
+        std::unordered_set<eid_t>{A, B, C});
+    CHECK(g.reachable({A}, all, 0) == std::unordered_set<eid_t>{A, B, C, D, E});
+    CHECK(g.reachable({A}, all, 0, 1) == std::unordered_set<eid_t>{A, B, E});
+    CHECK(g.reachable({D}, 0, all) == std::unordered_set<eid_t>{A, B, C, D});
+    CHECK(g.reachable({C}, association, association) ==
+        std::unordered_set<eid_t>{A, B, C});
+    CHECK(g.reachable({C}, all, 0, 0) == std::unordered_set<eid_t>{C});
+}
+
+TEST_CASE("Test sequence_diagram::model::diagram from_to message chains")
+{
+    using clanguml::common::eid_t;
+    using clanguml::common::model::message_t;
+    using clanguml::sequence_diagram::model::activity;
+    using clanguml::sequence_diagram::model::diagram;
+    using clanguml::sequence_diagram::model::message;
+
+    const eid_t main{uint64_t{1}}, a{uint64_t{2}}, b{uint64_t{3}},
+        c{uint64_t{4}};
+
+    diagram d;
+    auto add_call = [&d](eid_t from, eid_t to, std::string name) {
+        message m{message_t::kCall, from};
+        m.set_to(to);
+        m.set_message_name(std::move(name));
+        d.sequences().try_emplace(from, activity{from});
+        d.sequences().at(from).add_message(std::move(m));
+    };
+
+    add_call(main, a, "a");
+    add_call(main, b, "b");
+    add_call(a, c, "c");
+    add_call(b, c, "c");
+    // Call loops are ignored
+    add_call(c, a, "a");
+
+    auto chains = d.get_all_from_to_message_chains(main, c);
+    REQUIRE(chains.size() == 2);
+    CHECK(chains[0].size() == 2);
+    CHECK(chains[0][0].to() == a);
+    CHECK(chains[0][1].from() == a);
+    CHECK(chains[1][0].to() == b);
+    CHECK(chains[1][1].from() == b);
+
+    CHECK(d.get_all_from_to_message_chains(eid_t{}, c).size() == 2);
+    CHECK(d.get_all_from_to_message_chains(b, c).empty());
+
+    // Limit the depth and the number of message chains
+    CHECK(d.get_all_from_to_message_chains(main, c, 1).empty());
+    CHECK(d.get_all_from_to_message_chains(eid_t{}, c, 1).size() == 2);
+    CHECK(d.get_all_from_to_message_chains(main, c, 0, 1).size() == 1);
+}
+
+TEST_CASE("Test sequence_diagram::generators::text_activity_renderer")
+{
+    using clanguml::common::eid_t;
+    using clanguml::sequence_diagram::generators::text_activity_renderer;
+
+    const eid_t a{uint64_t{1}}, b{uint64_t{2}}, c{uint64_t{3}};
+
+    text_activity_renderer r;
+    auto generated_a{0};
+    auto generated_b{0};
+
+    // Activity b calls activity c
+    auto render_b = [&](std::ostream &ostr) {
+        r.render(b, ostr, [&](std::ostream &b_ostr) {
+            generated_b++;
+            b_ostr << (r.should_expand(c) ? "b->c;" : "b;");
+        });
+    };
+
+    // Activity a calls activity b, and optionally has state dependent output
+    auto render_a = [&](bool stateful) {
+        std::ostringstream ostr;
+        r.render(a, ostr, [&](std::ostream &a_ostr) {
+            generated_a++;
+            if (stateful)
+                r.set_stateful();
+            a_ostr << "a->";
+            if (r.should_expand(b))
+                render_b(a_ostr);
+            a_ostr << "a;";
+        });
+        return ostr.str();
+    };
+
+    CHECK(render_a(true) == "a->b->c;a;");
+    CHECK(generated_a == 1);
+    CHECK(generated_b == 1);
+
+    // Nested activity b was memoized, even though a was stateful
+    CHECK(render_a(false) == "a->b->c;a;");
+    CHECK(generated_a == 2);
+    CHECK(generated_b == 1);
+
+    // Memoized output is reused
+    CHECK(render_a(false) == "a->b->c;a;");
+    CHECK(generated_a == 2);
+
+    std::ostringstream b_ostr;
+    render_b(b_ostr);
+    CHECK(b_ostr.str() == "b->c;");
+    CHECK(generated_b == 1);
+
+    // Memoized output is not reused when any callee is on the call stack
+    r.push(a);
+    CHECK(render_a(false) == "a->b->c;a;");
+    CHECK(generated_a == 2);
+    r.push(c);
+    CHECK(render_a(false) == "a->b;a;");
+    CHECK(generated_a == 3);
+    CHECK(generated_b == 2);
+    r.pop(c);
+    r.pop(a);
+
+    CHECK(render_a(false) == "a->b->c;a;");
+    CHECK(generated_a == 3);
+    CHECK(generated_b == 2);
+}
+
+TEST_CASE("Test sequence_diagram::generators::activity_renderer")
+{
+    using clanguml::common::eid_t;
+    using clanguml::sequence_diagram::generators::activity_renderer;
+
+    const eid_t a{uint64_t{1}}, b{uint64_t{2}};
+
+    activity_renderer<std::string> r;
+    auto generated_a{0};
+    auto generated_b{0};
+
+    auto render_b = [&](bool stateful) {
+        std::string result;
+        r.render(
+            b,
+            [&]() {
+                generated_b++;
+                if (stateful)
+                    r.set_stateful();
+                result = "b";
+                return result;
+            },
+            [&](const std::string &fragment) { result = fragment; });
+        return result;
+    };
+
+    // Activity a calls activity b
+    auto render_a = [&]() {
+        std::string result;
+        r.render(
+            a,
+            [&]() {
+                generated_a++;
+                result = "a->" + (r.should_expand(b) ? render_b(false) : "");
+                return result;
+            },
+            [&](const std::string &fragment) { result = fragment; });
+        return result;
+    };
+
+    CHECK(render_b(true) == "b");
+    CHECK(generated_b == 1);
+
+    // Only leaf activities are memoized
+    CHECK(render_a() == "a->b");
+    CHECK(render_a() == "a->b");
+    CHECK(generated_a == 2);
+    CHECK(generated_b == 2);
+
+    CHECK(render_b(false) == "b");
+    CHECK(generated_b == 2);
+}
+
 TEST_CASE("Test path_type")
 {
     using namespace clanguml::common::model;
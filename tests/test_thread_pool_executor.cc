@@ -43,3 +43,104 @@ TEST_CASE("Test thread_pool_executor")
 
     CHECK(counter == kTaskCount);
 }
+
+TEST_CASE("Test thread_pool_executor nested tasks")
+{
+    using clanguml::util::thread_pool_executor;
+
+    thread_pool_executor pool{2};
+
+    CHECK(thread_pool_executor::current() == nullptr);
+
+    thread_pool_executor *worker_pool{nullptr};
+    pool.add([&worker_pool]() {
+            worker_pool = thread_pool_executor::current();
+        })
+        .get();
+    CHECK(worker_pool == &pool);
+
+    std::atomic_int counter{0};
+
+    std::vector<std::future<void>> futs;
+
+    const unsigned int kTaskCount = 10;
+    const unsigned int kNestedTaskCount = 100;
+
+    // Each task waits for its nested tasks in the same pool, which would
+    // deadlock if waiting workers did not execute the queued tasks
+    for (auto i = 0U; i < kTaskCount; i++) {
+        futs.emplace_back(pool.add([&pool, &counter]() {
+            std::vector<std::future<void>> nested_futs;
+            for (auto j = 0U; j < kNestedTaskCount; j++) {
+                nested_futs.emplace_back(
+                    pool.add([&counter]() { counter++; }));
+            }
+
+            pool.wait(nested_futs);
+        }));
+    }
+
+    pool.wait(futs);
+
+    CHECK(counter == kTaskCount * kNestedTaskCount);
+
+    std::vector<std::future<void>> failing_futs;
+    failing_futs.emplace_back(
+        pool.add([]() { throw std::runtime_error("failed"); }));
+    failing_futs.emplace_back(pool.add([&counter]() { counter++; }));
+
+    CHECK_THROWS_AS(pool.wait(failing_futs), std::runtime_error);
+    CHECK(counter == kTaskCount * kNestedTaskCount + 1);
+}
+
+TEST_CASE("Test thread_pool_executor wait does not run unrelated tasks")
+{
+    using clanguml::util::thread_pool_executor;
+    using namespace std::chrono_literals;
+
+    thread_pool_executor pool{2};
+
+    std::atomic_bool nested_started{false};
+    std::atomic_bool unrelated_added{false};
+    std::atomic_bool unrelated_run{false};
+    std::atomic_bool waiting{false};
+    std::atomic<std::thread::id> waiting_thread{};
+    std::atomic_bool unrelated_run_by_waiting_task{false};
+
+    auto fut = pool.add([&]() {
+        // The nested task is executed by the other worker, while this
+        // task waits for it
+        auto nested_fut = pool.add([&]() {
+            nested_started = true;
+
+            const auto deadline = std::chrono::steady_clock::now() + 200ms;
+            while (!unrelated_run &&
+                std::chrono::steady_clock::now() < deadline)
+                std::this_thread::yield();
+        });
+
+        while (!nested_started || !unrelated_added)
+            std::this_thread::yield();
+
+        waiting_thread = std::this_thread::get_id();
+        waiting = true;
+        pool.wait(nested_fut);
+        waiting = false;
+    });
+
+    while (!nested_started)
+        std::this_thread::yield();
+
+    auto unrelated_fut = pool.add([&]() {
+        unrelated_run_by_waiting_task =
+            waiting && waiting_thread.load() == std::this_thread::get_id();
+        unrelated_run = true;
+    });
+    unrelated_added = true;
+
+    fut.get();
+    unrelated_fut.get();
+
+    CHECK(unrelated_run);
+    CHECK_FALSE(unrelated_run_by_waiting_task);
+}
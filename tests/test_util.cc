@@ -17,10 +17,14 @@
  */
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 
+#include "util/interned_string.h"
 #include "util/util.h"
 #include <common/clang_utils.h>
 
+#include <spdlog/sinks/ostream_sink.h>
+
 #include <filesystem>
+#include <sstream>
 
 #include "doctest/doctest.h"
 
@@ -287,6 +291,24 @@ TEST_CASE("Test hash_seed")
     CHECK(hash_seed(1) != hash_seed(2));
 }
 
+TEST_CASE("Test hash64")
+{
+    using clanguml::util::hash64;
+
+    // Hash values must not change between platforms and releases
+    CHECK(hash64("") == 0x0409638ee2bde459ULL);
+    CHECK(hash64("a") == 0x28d2053309d28531ULL);
+    CHECK(hash64("abc") == 0x02a4f1d7cb516c72ULL);
+    CHECK(hash64("clanguml::A") == 0x364feec45e155496ULL);
+    CHECK(hash64("ns1::ns2::container<ns1::ns2::key_t,std::string>") ==
+        0x8f43c262404949a0ULL);
+    CHECK(hash64("ns1::ns2::Object::iterator<std::weak_ptr<Object> *,std::"
+                 "vector<std::weak_ptr<Object>,std::allocator<std::weak_ptr<"
+                 "Object>>>>") == 0x69dd248a9fb75d3aULL);
+
+    CHECK(hash64("abc", 1) != hash64("abc"));
+}
+
 TEST_CASE("Test tokenize_unexposed_template_parameter")
 {
     using namespace clanguml::common;
@@ -474,4 +496,128 @@ TEST_CASE("Test parse_source_location")
     CHECK(column == 456);
 
     result = false, file = "", line = 0, column = 0;
-}
\ No newline at end of file
+}
+
+TEST_CASE("Test logging macros")
+{
+    using namespace clanguml::util;
+
+    std::ostringstream ostr;
+    auto logger = std::make_shared<spdlog::logger>(kLoggerName,
+        std::make_shared<spdlog::sinks::ostream_sink_mt>(ostr));
+    logger->set_pattern("%v");
+    logger->set_level(spdlog::level::info);
+
+    clanguml::util::register_logger(logger);
+
+    CHECK(clanguml::util::logger() == logger.get());
+    CHECK(spdlog::get(kLoggerName) == logger);
+
+    auto evaluated{0};
+    auto count = [&evaluated]() { return ++evaluated; };
+
+    LOG_DBG("debug {}", count());
+    LOG_TRACE("trace {}", count());
+    CHECK(evaluated == 0);
+    CHECK(ostr.str().empty());
+
+    LOG_INFO("info {}", count());
+    CHECK(evaluated == 1);
+    CHECK(ostr.str().find("info 1") != std::string::npos);
+    CHECK(ostr.str().find("test_util.cc") != std::string::npos);
+
+    // Replace the logger writing to ostr with a logger without sinks
+    clanguml::util::register_logger(
+        std::make_shared<spdlog::logger>(kLoggerName));
+
+    // The replaced logger is kept alive for threads, which still use it
+    CHECK(logger.use_count() > 1);
+}
+
+TEST_CASE("Test interned_string")
+{
+    using clanguml::util::interned_string;
+
+    const interned_string empty;
+    CHECK(empty.empty());
+    CHECK(empty.str().empty());
+    CHECK(empty == interned_string{""});
+
+    std::string path{"/tmp/a/b/c.h"};
+    const interned_string a{path};
+    const interned_string b{std::string{"/tmp/a/b/"} + "c.h"};
+    const interned_string c{"/tmp/a/b/d.h"};
+
+    CHECK(a == b);
+    CHECK(&a.str() == &b.str());
+    CHECK(a != c);
+    CHECK(a.str() == path);
+    CHECK(std::hash<interned_string>{}(a) == std::hash<interned_string>{}(b));
+
+    // Interning a view of an already interned value returns the same string
+    const std::string_view view{"/tmp/a/b/c.hpp"};
+    CHECK(&interned_string{view.substr(0, path.size())}.str() == &a.str());
+
+    path = "modified";
+    CHECK(a.str() == "/tmp/a/b/c.h");
+}
+
+TEST_CASE("Test normalize_path")
+{
+    using clanguml::util::normalize_path;
+    namespace fs = std::filesystem;
+
+    const auto root = fs::temp_directory_path() / "clanguml_test_normalize";
+    fs::create_directories(root / "include");
+
+    const auto &header = normalize_path(root / "src/../include/a.h", root);
+
+    CHECK(header.absolute == (root / "include/a.h").lexically_normal());
+    CHECK(header.relative == fs::path{"include/a.h"});
+    CHECK(header.is_relative_to_root);
+
+    // Normalized paths are computed once and cached
+    CHECK(&normalize_path(root / "src/../include/a.h", root) == &header);
+
+    const auto outside_path = root.parent_path() / "clanguml_other" / "b.h";
+    const auto &outside = normalize_path(outside_path, root);
+    CHECK(!outside.is_relative_to_root);
+    CHECK(outside.absolute == outside_path.lexically_normal());
+
+    fs::remove_all(root);
+}
+
+TEST_CASE("Test normalize_path with relative paths")
+{
+    using clanguml::util::normalize_path;
+    namespace fs = std::filesystem;
+
+    const auto root = fs::temp_directory_path() / "clanguml_test_normalize_cwd";
+    fs::create_directories(root / "a");
+    fs::create_directories(root / "b");
+
+    const auto cwd = fs::current_path();
+
+    // Clang tool changes the working directory to the directory of each
+    // compile command, so the same relative path can refer to different
+    // files
+    fs::current_path(root / "a");
+    const auto dir_a = fs::current_path();
+    const auto &in_a = normalize_path("include/../x.h", root);
+
+    fs::current_path(root / "b");
+    const auto dir_b = fs::current_path();
+    const auto &in_b = normalize_path("include/../x.h", root);
+
+    fs::current_path(cwd);
+
+    CHECK(in_a.absolute == dir_a / "x.h");
+    CHECK(in_a.relative == fs::path{"a/x.h"});
+    CHECK(in_b.absolute == dir_b / "x.h");
+    CHECK(in_b.relative == fs::path{"b/x.h"});
+
+    // Relative and absolute paths to the same file share the cached entry
+    CHECK(&normalize_path(dir_a / "x.h", root) == &in_a);
+
+    fs::remove_all(root);
+}